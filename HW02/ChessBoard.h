@@ -0,0 +1,424 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <numeric>
+#include <algorithm>
+
+#include "../common/CoolingSchedule.h"
+#include "../common/SimulatedAnnealing.h"
+
+using namespace std;
+
+//--------------------------------------------------------------------------------------------------------
+
+// How queens are placed on the board
+enum class Encoding {
+    // Every queen gets a random row, rows may repeat, move = put one queen into a random row
+    RANDOM_ROWS,
+    // m_Queens is always a permutation of rows, move = swap rows of two columns (no row conflicts possible)
+    PERMUTATION
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class ChessBoard {
+public:
+    // Without a seed one is drawn from random_device, getSeed() returns it so the run can be repeated
+    ChessBoard(int N, Encoding encoding = Encoding::RANDOM_ROWS, unsigned int seed = random_device{}())
+            : m_N(N), m_Encoding(encoding), m_Seed(seed), m_Gen(seed) {
+        m_Queens.resize(N);
+        PRINT_MODE = true;
+        PRINT_RESULT = true;
+    }
+
+    // Constructive placement unless randomised solution is requested (or N has no explicit construction)
+    AnnealingResult solve(bool randomised = false);
+
+    unsigned int getSeed() const { return m_Seed; }
+
+    // Explicit O(N) construction, valid for N = 1 and every N >= 4
+    bool constructSolution();
+
+    // O(N) check with row and diagonal occupancy arrays
+    bool verifySolution() const;
+
+    // Default schedule: start at 30000, geometric cooling 0.95, stop after 5000 steps without improvement
+    AnnealingResult simulatedAnnealing();
+
+    template <typename Schedule>
+    AnnealingResult simulatedAnnealing(Schedule schedule);
+
+    // Problem policy for SimulatedAnnealing - moves are applied first and reverted when rejected
+    static constexpr bool SCORE_BEFORE_APPLY = false;
+    int initialize();
+    void proposeMove();
+    int moveDelta() const { return m_MoveDelta; }
+    void applyMove();
+    void revertMove();
+    bool isSolved(int conflicts) const { return conflicts == 0; }
+
+    int getRandomInt(int n);
+    int computeConflicts();
+    void initPositions();
+
+    // Permutation encoding only - diagonal occupancy counters and O(1) swap delta
+    void initDiagonals();
+    int computeDiagonalConflicts();
+    int swapQueens(int i, int j);
+
+    // printResult - print the final board when not animating (benchmarks turn both off)
+    void setPrintMode(bool printMode, bool printResult = true) { PRINT_MODE = printMode; PRINT_RESULT = printResult; }
+
+    void printSquare(bool isBlack, bool hasQueen);
+    void print(unsigned long step, int conflicts, double temp);
+
+    // Observer for SimulatedAnnealing - animation and final board
+    struct Printer {
+        ChessBoard & m_Board;
+
+        void onStart(int) {}
+        void onStep(unsigned long step, int conflicts, double temp);
+        void onFinish(unsigned long step, int conflicts, double temp);
+    };
+
+private:
+    int m_N;
+    Encoding m_Encoding;
+    unsigned int m_Seed;
+    mt19937 m_Gen;
+    bool PRINT_MODE;
+    bool PRINT_RESULT;
+
+    // Index represents column and value represents row
+    vector<int> m_Queens;
+
+    // Number of queens on each diagonal, indexed by (row + col) and (row - col + N - 1)
+    vector<int> m_DiagUp;
+    vector<int> m_DiagDown;
+
+    // Proposed move - column and new row (RANDOM_ROWS) or second column (PERMUTATION)
+    int m_MoveCol;
+    int m_MoveTarget;
+    int m_OldRow;
+    int m_MoveDelta;
+    int m_Conflicts;
+
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int ChessBoard::computeConflicts() {
+    int conflicts = 0;
+
+    for (int i = 0; i < m_N; ++i) {
+        for (int j = i + 1; j < m_N; ++j) {
+
+            // Row conflict
+            if(m_Queens[i] == m_Queens[j]) {
+                conflicts++;
+            }
+
+            // Diagonal conflict
+            // If distance between queens in row and distance between queens in columns are equal
+            if(abs(m_Queens[i] - m_Queens[j]) == abs(i - j)) {
+                conflicts++;
+            }
+
+        }
+    }
+
+    return conflicts;
+
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline AnnealingResult ChessBoard::solve(bool randomised) {
+    if(!randomised && constructSolution()) {
+        if(PRINT_MODE || PRINT_RESULT) {
+            print(0, 0, 0);
+        }
+        return {0, 0, true};
+    }
+
+    return simulatedAnnealing();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Rows (1-based) are all even numbers followed by all odd numbers, with a fix-up of the lists
+// when N % 6 is 2 or 3 - then the plain even/odd order puts two queens on one diagonal
+inline bool ChessBoard::constructSolution() {
+    if(m_N == 2 || m_N == 3) {
+        return false;
+    }
+
+    vector<int> evens;
+    vector<int> odds;
+    evens.reserve(m_N / 2);
+    odds.reserve(m_N / 2 + 1);
+
+    for (int row = 2; row <= m_N; row += 2) {
+        evens.push_back(row);
+    }
+    for (int row = 1; row <= m_N; row += 2) {
+        odds.push_back(row);
+    }
+
+    if(m_N % 6 == 2) {
+        // 1 3 5 7 ... -> 3 1 7 ... 5
+        swap(odds[0], odds[1]);
+        odds.erase(odds.begin() + 2);
+        odds.push_back(5);
+    } else if(m_N % 6 == 3) {
+        // 2 4 6 ... -> 4 6 ... 2 and 1 3 5 7 ... -> 5 7 ... 1 3
+        evens.erase(evens.begin());
+        evens.push_back(2);
+        odds.erase(odds.begin(), odds.begin() + 2);
+        odds.push_back(1);
+        odds.push_back(3);
+    }
+
+    int col = 0;
+    for (int row : evens) {
+        m_Queens[col++] = row - 1;
+    }
+    for (int row : odds) {
+        m_Queens[col++] = row - 1;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool ChessBoard::verifySolution() const {
+    vector<char> rows(m_N, 0);
+    vector<char> diagUp(2 * m_N - 1, 0);
+    vector<char> diagDown(2 * m_N - 1, 0);
+
+    for (int col = 0; col < m_N; ++col) {
+        int row = m_Queens[col];
+        if(row < 0 || row >= m_N) {
+            return false;
+        }
+
+        char & r = rows[row];
+        char & up = diagUp[row + col];
+        char & down = diagDown[row - col + m_N - 1];
+        if(r || up || down) {
+            return false;
+        }
+        r = up = down = 1;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::initPositions() {
+
+    if(m_Encoding == Encoding::PERMUTATION) {
+        iota(m_Queens.begin(), m_Queens.end(), 0);
+
+        shuffle(m_Queens.begin(), m_Queens.end(), m_Gen);
+
+        initDiagonals();
+        return;
+    }
+
+    for (int i = 0; i < m_N; ++i) {
+        m_Queens[i] = getRandomInt(m_N);
+    }
+
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::initDiagonals() {
+    m_DiagUp.assign(2 * m_N - 1, 0);
+    m_DiagDown.assign(2 * m_N - 1, 0);
+
+    for (int col = 0; col < m_N; ++col) {
+        m_DiagUp[m_Queens[col] + col]++;
+        m_DiagDown[m_Queens[col] - col + m_N - 1]++;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Same value as computeConflicts() for a permutation, but in O(N) - every diagonal with c queens gives c*(c-1)/2 pairs
+inline int ChessBoard::computeDiagonalConflicts() {
+    int conflicts = 0;
+
+    for (size_t d = 0; d < m_DiagUp.size(); ++d) {
+        conflicts += m_DiagUp[d] * (m_DiagUp[d] - 1) / 2;
+        conflicts += m_DiagDown[d] * (m_DiagDown[d] - 1) / 2;
+    }
+
+    return conflicts;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Swaps rows of queens in columns i and j and returns the change of conflicts.
+// Calling it again with the same columns reverts the move.
+inline int ChessBoard::swapQueens(int i, int j) {
+    int delta = 0;
+
+    // Removing a queen from a diagonal with c queens removes c-1 pairs, adding it to one with c queens adds c pairs
+    auto removeQueen = [&](int col) {
+        delta -= --m_DiagUp[m_Queens[col] + col];
+        delta -= --m_DiagDown[m_Queens[col] - col + m_N - 1];
+    };
+    auto addQueen = [&](int col) {
+        delta += m_DiagUp[m_Queens[col] + col]++;
+        delta += m_DiagDown[m_Queens[col] - col + m_N - 1]++;
+    };
+
+    removeQueen(i);
+    removeQueen(j);
+    swap(m_Queens[i], m_Queens[j]);
+    addQueen(i);
+    addQueen(j);
+
+    return delta;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int ChessBoard::getRandomInt(int n) {
+    uniform_int_distribution<> distr(0, n - 1);
+
+    return distr(m_Gen);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline AnnealingResult ChessBoard::simulatedAnnealing() {
+    return simulatedAnnealing(GeometricSchedule(30000, 0.95, 5000));
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Schedule>
+AnnealingResult ChessBoard::simulatedAnnealing(Schedule schedule) {
+    return SimulatedAnnealing<ChessBoard, Schedule, mt19937, Printer>(*this, schedule, m_Gen, Printer{*this}).run();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int ChessBoard::initialize() {
+    initPositions();
+    m_Conflicts = m_Encoding == Encoding::PERMUTATION ? computeDiagonalConflicts() : computeConflicts();
+
+    return m_Conflicts;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::proposeMove() {
+    m_MoveCol = getRandomInt(m_N);
+    m_MoveTarget = getRandomInt(m_N);
+
+    // Swap with another column, target is used as the second column
+    if(m_Encoding == Encoding::PERMUTATION && m_MoveTarget == m_MoveCol) {
+        m_MoveTarget = (m_MoveTarget + 1) % m_N;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::applyMove() {
+    if(m_Encoding == Encoding::PERMUTATION) {
+        m_MoveDelta = swapQueens(m_MoveCol, m_MoveTarget);
+    } else {
+        m_OldRow = m_Queens[m_MoveCol];
+        m_Queens[m_MoveCol] = m_MoveTarget;
+        m_MoveDelta = computeConflicts() - m_Conflicts;
+    }
+
+    m_Conflicts += m_MoveDelta;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::revertMove() {
+    if(m_Encoding == Encoding::PERMUTATION) {
+        swapQueens(m_MoveCol, m_MoveTarget);
+    } else {
+        m_Queens[m_MoveCol] = m_OldRow;
+    }
+
+    m_Conflicts -= m_MoveDelta;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::Printer::onStep(unsigned long step, int conflicts, double temp) {
+    if(m_Board.PRINT_MODE) {
+        // system("clear");
+        cout << "\033[H";
+        m_Board.print(step, conflicts, temp);
+        this_thread::sleep_for(chrono::milliseconds(50));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::Printer::onFinish(unsigned long step, int conflicts, double temp) {
+    if(!m_Board.PRINT_MODE && m_Board.PRINT_RESULT) {
+        m_Board.print(step, conflicts, temp);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::printSquare(bool isBlack, bool hasQueen) {
+    string blackBg = "\033[40m";
+    string whiteBg = "\033[47m";
+
+    string queenColor = "\033[93m";
+    string bold = "\033[1m";
+    string reset = "\033[0m";
+
+    string bgColor = isBlack ? blackBg : whiteBg;
+
+    cout << bgColor << bold;
+    if (hasQueen) {
+        cout << queenColor << " Q" << reset << bgColor << " ";
+    } else {
+        cout << "   ";
+    }
+    cout << reset;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ChessBoard::print(unsigned long step, int conflicts, double temp) {
+    string bold = "\033[1m";
+    string reset = "\033[0m";
+
+    cout << bold;
+    cout << "STEP: " << step << endl;
+    cout << "Conflicts: " << conflicts << "               " << endl;
+    cout << "Temperature: " << temp <<    "               " << endl;
+
+    cout << reset;
+
+    for (int i = 0; i < m_N; ++i) {
+        for (int j = 0; j < m_N; ++j) {
+            bool isBlack = (i + j) % 2 == 0;
+            bool hasQueen = m_Queens[i] == j;
+            printSquare(isBlack, hasQueen);
+        }
+        cout << endl;
+    }
+}
@@ -0,0 +1,315 @@
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "ChessBoard.h"
+
+using namespace std;
+
+// encodings - compares queen encodings on steps to solution and wall time
+// schedules - compares cooling schedules on time-to-solution distribution over seeds
+// sweep     - seeded time-to-solution suite, writes every run to CSV and per-N summaries to JSON
+// construct - explicit O(N) construction + verifier against annealing (annealing only up to --anneal-max)
+//
+// Every mode runs seeds seedBase..seedBase+runs-1 for each N, so results are comparable across builds.
+// Build: g++ -std=c++17 -O2 benchmark.cpp -o benchmark
+
+//--------------------------------------------------------------------------------------------------------
+
+struct RunRecord {
+    int N;
+    unsigned int seed;
+    unsigned long steps;
+    double ms;
+    int conflicts;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+struct RunStats {
+    int solved = 0;
+    vector<RunRecord> runs;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+struct BenchmarkOptions {
+    string mode;
+    int minN = 8;
+    int maxN = 8;
+    int runs = 10;
+
+    // N += step, or N *= 2 when step is 0
+    int step = 0;
+    unsigned int seedBase = 0;
+    Encoding encoding = Encoding::PERMUTATION;
+
+    string csvPath;
+    string jsonPath;
+
+    // Largest N for which the construct mode also runs annealing
+    int annealMax = 4096;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+double percentile(vector<double> values, double p) {
+    if(values.empty()) return 0;
+
+    sort(values.begin(), values.end());
+    size_t idx = (size_t) ceil(p * values.size()) - 1;
+
+    return values[min(idx, values.size() - 1)];
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Schedule>
+RunStats runSeeds(int N, Encoding encoding, const Schedule & schedule, const BenchmarkOptions & opts) {
+    RunStats stats;
+
+    for (int i = 0; i < opts.runs; ++i) {
+        unsigned int seed = opts.seedBase + i;
+        ChessBoard board{N, encoding, seed};
+        board.setPrintMode(false, false);
+
+        auto start = chrono::steady_clock::now();
+        AnnealingResult result = board.simulatedAnnealing(schedule);
+        auto end = chrono::steady_clock::now();
+
+        if(result.solved) {
+            stats.solved++;
+        }
+        stats.runs.push_back({N, seed, result.steps, chrono::duration<double, milli>(end - start).count(),
+                              result.score});
+    }
+
+    return stats;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename T>
+vector<double> collect(const RunStats & stats, T RunRecord::* field) {
+    vector<double> values;
+    for (const auto & run : stats.runs) {
+        values.push_back(run.*field);
+    }
+    return values;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void printRow(int N, const string & label, const RunStats & stats) {
+    vector<double> steps = collect(stats, &RunRecord::steps);
+    vector<double> ms = collect(stats, &RunRecord::ms);
+
+    cout << setw(8) << N
+         << setw(14) << label
+         << setw(10) << stats.solved << "/" << setw(4) << left << stats.runs.size() << right
+         << setw(14) << fixed << setprecision(1) << percentile(steps, 0.5)
+         << setw(14) << percentile(steps, 0.95)
+         << setw(14) << setprecision(3) << percentile(ms, 0.5)
+         << setw(14) << percentile(ms, 0.95) << endl;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void printHeader(const string & label) {
+    cout << setw(8) << "N" << setw(14) << label << setw(15) << "solved"
+         << setw(14) << "median steps" << setw(14) << "p95 steps"
+         << setw(14) << "median ms" << setw(14) << "p95 ms" << endl;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void writeCsv(const string & path, const vector<RunStats> & sweep) {
+    ofstream out(path, ios::out | ios::trunc);
+
+    out << "n,seed,steps,wall_ms,solved,conflicts\n";
+    for (const auto & stats : sweep) {
+        for (const auto & run : stats.runs) {
+            out << run.N << "," << run.seed << "," << run.steps << "," << run.ms << ","
+                << (run.conflicts == 0) << "," << run.conflicts << "\n";
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void writeJson(const string & path, const vector<RunStats> & sweep, const BenchmarkOptions & opts) {
+    ofstream out(path, ios::out | ios::trunc);
+
+    out << "{\n";
+    out << "  \"encoding\": \"" << (opts.encoding == Encoding::PERMUTATION ? "permutation" : "random-rows") << "\",\n";
+    out << "  \"seed_base\": " << opts.seedBase << ",\n";
+    out << "  \"runs_per_n\": " << opts.runs << ",\n";
+    out << "  \"results\": [\n";
+
+    for (size_t i = 0; i < sweep.size(); ++i) {
+        const RunStats & stats = sweep[i];
+        vector<double> steps = collect(stats, &RunRecord::steps);
+        vector<double> ms = collect(stats, &RunRecord::ms);
+        vector<double> conflicts = collect(stats, &RunRecord::conflicts);
+
+        out << "    {\"n\": " << stats.runs.front().N
+            << ", \"runs\": " << stats.runs.size()
+            << ", \"success_rate\": " << (double) stats.solved / stats.runs.size()
+            << ", \"steps_median\": " << percentile(steps, 0.5)
+            << ", \"steps_p95\": " << percentile(steps, 0.95)
+            << ", \"wall_ms_median\": " << percentile(ms, 0.5)
+            << ", \"wall_ms_p95\": " << percentile(ms, 0.95)
+            << ", \"conflicts_median\": " << percentile(conflicts, 0.5)
+            << ", \"conflicts_max\": " << percentile(conflicts, 1.0) << "}"
+            << (i + 1 < sweep.size() ? "," : "") << "\n";
+    }
+
+    out << "  ]\n";
+    out << "}\n";
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void benchmarkConstruction(int N, const BenchmarkOptions & opts) {
+    ChessBoard board{N, Encoding::PERMUTATION, opts.seedBase};
+    board.setPrintMode(false, false);
+
+    auto start = chrono::steady_clock::now();
+    bool constructed = board.constructSolution();
+    auto mid = chrono::steady_clock::now();
+    bool valid = constructed && board.verifySolution();
+    auto end = chrono::steady_clock::now();
+
+    cout << setw(10) << N
+         << setw(8) << (valid ? "yes" : "no")
+         << setw(14) << fixed << setprecision(3) << chrono::duration<double, milli>(mid - start).count()
+         << setw(14) << chrono::duration<double, milli>(end - mid).count();
+
+    if(N <= opts.annealMax) {
+        RunStats stats = runSeeds(N, Encoding::PERMUTATION, GeometricSchedule(30000, 0.95, 5000), opts);
+        cout << setw(10) << stats.solved << "/" << setw(4) << left << stats.runs.size() << right
+             << setw(14) << percentile(collect(stats, &RunRecord::ms), 0.5);
+    } else {
+        cout << setw(15) << "-" << setw(14) << "-";
+    }
+
+    cout << endl;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void printUsage(const char * name) {
+    cout << name << " [encodings|schedules|sweep|construct] [minN] [maxN] [runs]"
+         << " [--step K] [--seed-base S] [--encoding random-rows|permutation] [--csv file] [--json file]"
+         << " [--anneal-max N]" << endl;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool parseOptions(int argc, char ** argv, BenchmarkOptions & opts) {
+    if(argc < 5) return false;
+
+    opts.mode = argv[1];
+    opts.minN = atoi(argv[2]);
+    opts.maxN = atoi(argv[3]);
+    opts.runs = atoi(argv[4]);
+
+    for (int i = 5; i < argc; ++i) {
+        string arg = argv[i];
+        if(i + 1 >= argc) return false;
+        string value = argv[++i];
+
+        if(arg == "--step") {
+            opts.step = atoi(value.c_str());
+        } else if(arg == "--seed-base") {
+            opts.seedBase = strtoul(value.c_str(), nullptr, 10);
+        } else if(arg == "--encoding" && (value == "random-rows" || value == "permutation")) {
+            opts.encoding = value == "permutation" ? Encoding::PERMUTATION : Encoding::RANDOM_ROWS;
+        } else if(arg == "--csv") {
+            opts.csvPath = value;
+        } else if(arg == "--json") {
+            opts.jsonPath = value;
+        } else if(arg == "--anneal-max") {
+            opts.annealMax = atoi(value.c_str());
+        } else {
+            return false;
+        }
+    }
+
+    return opts.minN > 0 && opts.maxN >= opts.minN && opts.runs > 0 && opts.step >= 0;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Next size, 0 when it would be over maxN. Compared before stepping, so N never overflows near INT_MAX
+int nextN(int N, const BenchmarkOptions & opts) {
+    if(opts.step > 0) {
+        return N > opts.maxN - opts.step ? 0 : N + opts.step;
+    }
+    return N > opts.maxN / 2 ? 0 : N * 2;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int main ( int argc, char ** argv ) {
+    BenchmarkOptions opts;
+
+    if(!parseOptions(argc, argv, opts)) {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if(opts.mode == "encodings") {
+        printHeader("encoding");
+
+        for (int N = opts.minN; N != 0; N = nextN(N, opts)) {
+            GeometricSchedule schedule{30000, 0.95, 5000};
+            printRow(N, "random-rows", runSeeds(N, Encoding::RANDOM_ROWS, schedule, opts));
+            printRow(N, "permutation", runSeeds(N, Encoding::PERMUTATION, schedule, opts));
+        }
+    } else if(opts.mode == "schedules") {
+        printHeader("schedule");
+
+        for (int N = opts.minN; N != 0; N = nextN(N, opts)) {
+            GeometricSchedule geometric{30000, 0.95, 5000};
+            AdaptiveSchedule adaptive{30000, 0.3, 50, 5000};
+            ReheatingSchedule reheating{30000, 0.95, 5000, 2, 20};
+
+            printRow(N, geometric.name(), runSeeds(N, opts.encoding, geometric, opts));
+            printRow(N, adaptive.name(), runSeeds(N, opts.encoding, adaptive, opts));
+            printRow(N, reheating.name(), runSeeds(N, opts.encoding, reheating, opts));
+        }
+    } else if(opts.mode == "sweep") {
+        printHeader("encoding");
+        vector<RunStats> sweep;
+
+        for (int N = opts.minN; N != 0; N = nextN(N, opts)) {
+            sweep.push_back(runSeeds(N, opts.encoding, GeometricSchedule(30000, 0.95, 5000), opts));
+            printRow(N, opts.encoding == Encoding::PERMUTATION ? "permutation" : "random-rows", sweep.back());
+        }
+
+        if(!opts.csvPath.empty()) {
+            writeCsv(opts.csvPath, sweep);
+        }
+        if(!opts.jsonPath.empty()) {
+            writeJson(opts.jsonPath, sweep, opts);
+        }
+    } else if(opts.mode == "construct") {
+        cout << setw(10) << "N" << setw(8) << "valid" << setw(14) << "construct ms" << setw(14) << "verify ms"
+             << setw(15) << "anneal solved" << setw(14) << "anneal ms" << endl;
+
+        for (int N = opts.minN; N != 0; N = nextN(N, opts)) {
+            benchmarkConstruction(N, opts);
+        }
+    } else {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Level.h"
+
+using namespace std;
+
+// Deadlock detection for Sokoban, pushes into a deadlock are never generated.
+// Dead square = floor cell from which a box can never reach any goal. Computed once per level by pulling
+// a box from every goal backwards (box and player move away from each other), other boxes are ignored,
+// every cell never reached is dead.
+// Freeze deadlock = a box that cannot move along either axis, because of walls, dead squares on both sides
+// or other frozen boxes, and that is not on a goal (or another box frozen with it is not on a goal).
+
+//--------------------------------------------------------------------------------------------------------
+
+class Deadlocks {
+public:
+    Deadlocks(const Level & level);
+
+    bool isDeadSquare(int cell) const { return m_Dead[cell]; }
+    int getDeadSquareCount() const { return m_DeadCount; }
+
+    // Box just pushed to cell (already in boxMap) got frozen off a goal
+    bool isFreezeDeadlock(int cell, const uint8_t * boxMap);
+
+private:
+    bool isFrozen(int cell, const uint8_t * boxMap, bool & offGoal);
+    bool isBlocked(int cell, int offset, const uint8_t * boxMap, bool & offGoal);
+    bool isFrozenNeighbour(int cell, const uint8_t * boxMap, bool & offGoal);
+
+    const Level & m_Level;
+    vector<uint8_t> m_Dead;
+    int m_DeadCount;
+
+    // Boxes on the recursion path, checked as walls
+    vector<uint8_t> m_AsWall;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline Deadlocks::Deadlocks(const Level & level)
+        : m_Level(level), m_Dead(level.getCellCount(), 0), m_DeadCount(0), m_AsWall(level.getCellCount(), 0) {
+    vector<uint8_t> live(level.getCellCount(), 0);
+    vector<int> queue = level.getGoalCells();
+    for (int goal : queue) {
+        live[goal] = 1;
+    }
+
+    // Box on cell - offset can be pushed to cell when the player can stand on cell - 2 * offset
+    for (size_t i = 0; i < queue.size(); ++i) {
+        for (Direction dir : DIRECTIONS) {
+            int offset = level.offset(dir);
+            int from = queue[i] - offset;
+
+            if(!level.isWall(from) && !level.isWall(from - offset) && !live[from]) {
+                live[from] = 1;
+                queue.push_back(from);
+            }
+        }
+    }
+
+    for (int cell = 0; cell < level.getCellCount(); ++cell) {
+        if(!level.isWall(cell) && !live[cell]) {
+            m_Dead[cell] = 1;
+            m_DeadCount++;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool Deadlocks::isFreezeDeadlock(int cell, const uint8_t * boxMap) {
+    bool offGoal = false;
+    return isFrozen(cell, boxMap, offGoal) && offGoal;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool Deadlocks::isFrozen(int cell, const uint8_t * boxMap, bool & offGoal) {
+    m_AsWall[cell] = 1;
+    bool frozen = isBlocked(cell, 1, boxMap, offGoal) && isBlocked(cell, m_Level.getWidth(), boxMap, offGoal);
+    m_AsWall[cell] = 0;
+
+    if(frozen && !m_Level.isGoal(cell)) {
+        offGoal = true;
+    }
+
+    return frozen;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Box cannot move along the axis given by offset
+inline bool Deadlocks::isBlocked(int cell, int offset, const uint8_t * boxMap, bool & offGoal) {
+    int before = cell - offset;
+    int after = cell + offset;
+
+    if(m_Level.isWall(before) || m_Level.isWall(after) || m_AsWall[before] || m_AsWall[after]) {
+        return true;
+    }
+
+    if(m_Dead[before] && m_Dead[after]) {
+        return true;
+    }
+
+    return (boxMap[before] && isFrozenNeighbour(before, boxMap, offGoal))
+           || (boxMap[after] && isFrozenNeighbour(after, boxMap, offGoal));
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Boxes found frozen under an assumption that did not hold do not count
+inline bool Deadlocks::isFrozenNeighbour(int cell, const uint8_t * boxMap, bool & offGoal) {
+    bool neighbourOffGoal = offGoal;
+    if(isFrozen(cell, boxMap, neighbourOffGoal)) {
+        offGoal = neighbourOffGoal;
+        return true;
+    }
+    return false;
+}
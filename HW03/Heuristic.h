@@ -0,0 +1,227 @@
+#pragma once
+
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+
+#include "Level.h"
+
+using namespace std;
+
+// Lower bounds on the number of pushes to solve a Sokoban state.
+// Push distance = pushes needed to move a single box from a cell to a goal when other boxes are ignored,
+// computed by pulling a box backwards from every goal. Every box needs its own goal, so the minimum cost
+// box-to-goal matching is admissible and much stronger than the sum of distances to the nearest goals.
+
+//--------------------------------------------------------------------------------------------------------
+
+enum class PushHeuristic {
+    NONE,
+    NEAREST,
+    MATCHING
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class PushDistances {
+public:
+    // Distance of a cell from which no goal can be reached, a matching using it is a deadlock
+    static constexpr int INFINITE = 1 << 20;
+
+    PushDistances(const Level & level);
+
+    int get(int goal, int cell) const { return m_Dist[goal * m_Cells + cell]; }
+    int nearest(int cell) const { return m_Nearest[cell]; }
+
+private:
+    int m_Cells;
+
+    // [goal][cell]
+    vector<int> m_Dist;
+    vector<int> m_Nearest;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline PushDistances::PushDistances(const Level & level)
+        : m_Cells(level.getCellCount()), m_Dist(level.getGoalCells().size() * level.getCellCount(), INFINITE),
+          m_Nearest(level.getCellCount(), INFINITE) {
+    const vector<int> & goals = level.getGoalCells();
+
+    for (size_t goal = 0; goal < goals.size(); ++goal) {
+        int * dist = &m_Dist[goal * m_Cells];
+        vector<int> queue = {goals[goal]};
+        dist[goals[goal]] = 0;
+
+        // Same pulls as Deadlocks, breadth-first, so the distances are minimal
+        for (size_t i = 0; i < queue.size(); ++i) {
+            for (Direction dir : DIRECTIONS) {
+                int offset = level.offset(dir);
+                int from = queue[i] - offset;
+
+                if(!level.isWall(from) && !level.isWall(from - offset) && dist[from] == INFINITE) {
+                    dist[from] = dist[queue[i]] + 1;
+                    queue.push_back(from);
+                }
+            }
+        }
+
+        for (int cell = 0; cell < m_Cells; ++cell) {
+            m_Nearest[cell] = min(m_Nearest[cell], dist[cell]);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Minimum cost assignment of boxes (rows) to goals (columns), Hungarian method with potentials.
+// After a push only the row of the moved box changes: its assignment is dropped and one augmenting path
+// is found, O(n^2) instead of solving the whole O(n^3) assignment again.
+class Matching {
+public:
+    Matching(const PushDistances & distances, int boxCount);
+
+    // Solves the assignment from scratch, boxes in any order
+    int solve(const uint16_t * boxes);
+
+    // Box in the row (position in the array given to solve) moved to cell
+    int moveBox(int row, int cell);
+
+    // Matching cost, >= PushDistances::INFINITE when some box cannot get to a free goal
+    int cost() const;
+
+private:
+    static constexpr int BIG = INT_MAX / 2;
+
+    // Rows and columns are numbered from 1, 0 is the sentinel of the augmenting path
+    int cellCost(int row, int column) const { return m_Distances->get(column - 1, m_Cells[row]); }
+
+    void augment(int row);
+
+    const PushDistances * m_Distances;
+    int m_Size;
+
+    vector<int> m_Cells;
+
+    // Potentials of rows and columns, m_Assigned[column] = row
+    vector<int> m_U;
+    vector<int> m_V;
+    vector<int> m_Assigned;
+
+    vector<int> m_MinV;
+    vector<int> m_Way;
+    vector<uint8_t> m_Used;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline Matching::Matching(const PushDistances & distances, int boxCount)
+        : m_Distances(&distances), m_Size(boxCount), m_Cells(boxCount + 1, 0), m_U(boxCount + 1, 0),
+          m_V(boxCount + 1, 0), m_Assigned(boxCount + 1, 0), m_MinV(boxCount + 1), m_Way(boxCount + 1),
+          m_Used(boxCount + 1) {}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int Matching::solve(const uint16_t * boxes) {
+    fill(m_U.begin(), m_U.end(), 0);
+    fill(m_V.begin(), m_V.end(), 0);
+    fill(m_Assigned.begin(), m_Assigned.end(), 0);
+
+    for (int row = 1; row <= m_Size; ++row) {
+        m_Cells[row] = boxes[row - 1];
+    }
+    for (int row = 1; row <= m_Size; ++row) {
+        augment(row);
+    }
+
+    return cost();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Potentials of columns only decrease from 0 and costs are >= 0, so u = 0 keeps the changed row feasible
+inline int Matching::moveBox(int row, int cell) {
+    row++;
+    m_Cells[row] = cell;
+
+    for (int column = 1; column <= m_Size; ++column) {
+        if(m_Assigned[column] == row) {
+            m_Assigned[column] = 0;
+        }
+    }
+    m_U[row] = 0;
+
+    augment(row);
+    return cost();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int Matching::cost() const {
+    int total = 0;
+    for (int column = 1; column <= m_Size; ++column) {
+        total += cellCost(m_Assigned[column], column);
+    }
+    return min(total, PushDistances::INFINITE);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Shortest augmenting path from the free row in reduced costs, potentials keep them non-negative
+inline void Matching::augment(int row) {
+    fill(m_MinV.begin(), m_MinV.end(), BIG);
+    fill(m_Used.begin(), m_Used.end(), 0);
+
+    m_Assigned[0] = row;
+    int column = 0;
+
+    do {
+        m_Used[column] = 1;
+        int current = m_Assigned[column];
+        int delta = BIG;
+        int next = 0;
+
+        for (int j = 1; j <= m_Size; ++j) {
+            if(m_Used[j]) {
+                continue;
+            }
+
+            int reduced = cellCost(current, j) - m_U[current] - m_V[j];
+            if(reduced < m_MinV[j]) {
+                m_MinV[j] = reduced;
+                m_Way[j] = column;
+            }
+            if(m_MinV[j] < delta) {
+                delta = m_MinV[j];
+                next = j;
+            }
+        }
+
+        for (int j = 0; j <= m_Size; ++j) {
+            if(m_Used[j]) {
+                m_U[m_Assigned[j]] += delta;
+                m_V[j] -= delta;
+            } else {
+                m_MinV[j] -= delta;
+            }
+        }
+
+        column = next;
+    } while (m_Assigned[column] != 0);
+
+    // Flip the path
+    do {
+        int previous = m_Way[column];
+        m_Assigned[column] = m_Assigned[previous];
+        column = previous;
+    } while (column != 0);
+
+    // Column potentials only decrease, after many incremental updates they would overflow. Adding a constant
+    // to all rows and subtracting it from all columns changes no reduced cost, so keep the largest at 0.
+    int shift = *max_element(m_V.begin() + 1, m_V.end());
+    for (int i = 1; i <= m_Size; ++i) {
+        m_V[i] -= shift;
+        m_U[i] += shift;
+    }
+}
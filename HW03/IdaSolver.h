@@ -0,0 +1,212 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+
+#include "Level.h"
+#include "Zobrist.h"
+#include "TranspositionTable.h"
+#include "Heuristic.h"
+#include "PushExpander.h"
+#include "Solver.h"
+
+using namespace std;
+
+// IDA* over pushes, the same states and heuristics as PushSolver but memory does not grow with the search.
+// Depth-first search bounded by f = pushes + h, the bound is raised to the smallest f that exceeded it.
+// The transposition table is a small cache of (key -> pushes) of the current iteration: a state reached
+// again by no fewer pushes has already been searched with at least the same remaining bound. Only the key
+// is compared, the states themselves are not kept.
+// Children are searched by increasing h. Their states live in frames preallocated for the whole bound,
+// so the search itself allocates nothing.
+
+//--------------------------------------------------------------------------------------------------------
+
+class IdaSolver {
+public:
+    static constexpr size_t DEFAULT_TABLE_BYTES = 16 << 20;
+
+    IdaSolver(const Level & level, size_t tableBytes = DEFAULT_TABLE_BYTES);
+
+    bool solve(vector<Move> & plan);
+
+    void setPruning(bool pruning) { m_Expander.setPruning(pruning); }
+    void setHeuristic(PushHeuristic heuristic) { m_Expander.setHeuristic(heuristic); }
+
+    const SolverStats & stats() const { return m_Stats; }
+    const TranspositionTable & table() const { return m_Table; }
+    const Deadlocks & deadlocks() const { return m_Expander.deadlocks(); }
+
+    int getIterations() const { return m_Iterations; }
+
+private:
+    static constexpr int NOT_FOUND = INT_MAX;
+
+    struct Child {
+        int m_H;
+        uint32_t m_Slot;
+        uint64_t m_Key;
+        Push m_Push;
+
+        bool operator<(const Child & other) const { return m_H < other.m_H; }
+    };
+
+    // Frame of a depth: up to m_MaxChildren children and their states
+    Child * children(int depth) { return &m_Children[(size_t) depth * m_MaxChildren]; }
+    uint16_t * childState(int depth, uint32_t slot) {
+        return &m_States[((size_t) depth * m_MaxChildren + slot) * m_Stride];
+    }
+
+    // Searches below s (with its key) reached by depth pushes, true when a goal was found.
+    // f over the bound goes to m_Next.
+    bool search(const uint16_t * s, uint64_t key, int depth, int h);
+
+    // Smaller g than before in this iteration (or a lost entry), the state has to be searched
+    bool isNew(uint64_t key, int g);
+
+    int m_Stride;
+    int m_MaxChildren;
+
+    Zobrist m_Zobrist;
+    TranspositionTable m_Table;
+    PushDistances m_Distances;
+    PushExpander m_Expander;
+
+    vector<Child> m_Children;
+    vector<uint16_t> m_States;
+    vector<Push> m_Path;
+
+    int m_Bound;
+    int m_Next;
+    int m_Iterations;
+
+    SolverStats m_Stats;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline IdaSolver::IdaSolver(const Level & level, size_t tableBytes)
+        : m_Stride(level.getBoxCount() + 1), m_MaxChildren(4 * level.getBoxCount()), m_Zobrist(level.getCellCount()),
+          m_Table(tableBytes), m_Distances(level), m_Expander(level, m_Zobrist, m_Distances), m_Bound(0), m_Next(0),
+          m_Iterations(0) {
+    m_Expander.setHeuristic(PushHeuristic::MATCHING);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool IdaSolver::solve(vector<Move> & plan) {
+    auto start = chrono::steady_clock::now();
+
+    m_Stats = SolverStats();
+    m_Expander.clearStats();
+    m_Iterations = 0;
+    plan.clear();
+
+    vector<uint16_t> initial;
+    m_Expander.initial(initial);
+    uint64_t key = m_Expander.key(initial.data());
+    int h = m_Expander.evaluate(initial.data());
+
+    bool solved = false;
+    for (m_Bound = h; m_Bound < PushDistances::INFINITE; m_Bound = m_Next) {
+        // Every push adds 1 to f and h >= 0, so the path is at most m_Bound pushes long
+        m_Children.resize((size_t) (m_Bound + 1) * m_MaxChildren);
+        m_States.resize(m_Children.size() * m_Stride);
+        m_Path.resize(m_Bound + 1);
+
+        m_Table.clear();
+        m_Next = NOT_FOUND;
+        m_Iterations++;
+
+        isNew(key, 0);
+        if(search(initial.data(), key, 0, h)) {
+            solved = true;
+            break;
+        }
+    }
+
+    if(solved) {
+        m_Expander.buildPlan(m_Path, plan);
+    }
+
+    const SolverStats & expander = m_Expander.stats();
+    m_Stats.generated = expander.generated;
+    m_Stats.deadSquarePushes = expander.deadSquarePushes;
+    m_Stats.freezePushes = expander.freezePushes;
+    m_Stats.states = m_Table.stats().stored;
+    m_Stats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    return solved;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool IdaSolver::isNew(uint64_t key, int g) {
+    auto any = [](uint32_t) { return true; };
+
+    uint32_t * known = m_Table.find(key, any);
+    if(known) {
+        if(*known <= (uint32_t) g) {
+            return false;
+        }
+        *known = g;
+        return true;
+    }
+
+    // States near the root cut off larger subtrees, they are kept first
+    m_Table.insert(key, g, m_Bound - g, any);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool IdaSolver::search(const uint16_t * s, uint64_t key, int depth, int h) {
+    if(depth + h > m_Bound) {
+        m_Next = min(m_Next, depth + h);
+        return false;
+    }
+
+    if(m_Expander.isSolved(s)) {
+        m_Path.resize(depth);
+        return true;
+    }
+
+    m_Stats.expanded++;
+    m_Expander.evaluate(s);
+
+    Child * frame = children(depth);
+    uint32_t count = 0;
+
+    m_Expander.expand(s, key, [&](const Push & push, int row, const uint16_t * next, uint64_t nextKey) {
+        int childH = m_Expander.childHeuristic(push, row);
+        if(childH >= PushDistances::INFINITE) {
+            return true;
+        }
+
+        copy(next, next + m_Stride, childState(depth, count));
+        frame[count] = Child{childH, count, nextKey, push};
+        count++;
+        return true;
+    });
+
+    // Most promising children first, the goal is found earlier in the last iteration
+    sort(frame, frame + count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const Child & child = frame[i];
+        if(depth + 1 + child.m_H <= m_Bound && !isNew(child.m_Key, depth + 1)) {
+            continue;
+        }
+
+        m_Path[depth] = child.m_Push;
+        if(search(childState(depth, child.m_Slot), child.m_Key, depth + 1, child.m_H)) {
+            return true;
+        }
+    }
+
+    return false;
+}
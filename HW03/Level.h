@@ -0,0 +1,436 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+#include <algorithm>
+
+#include "Pddl.h"
+
+using namespace std;
+
+// Sokoban level on a grid.
+// Cells are numbered row by row, the grid has one extra wall cell on every side, so a neighbour of
+// a floor cell is always inside the grid and moves need no bounds checks.
+// Coordinates x, y (0-based, without the border) are the positions of PDDL objects in the inc chain,
+// m_Names keeps the object names to print actions in the syntax of sokoban.pddl.
+
+//--------------------------------------------------------------------------------------------------------
+
+enum Direction {
+    LEFT,
+    RIGHT,
+    UP,
+    DOWN
+};
+
+const Direction DIRECTIONS[] = {LEFT, RIGHT, UP, DOWN};
+
+//--------------------------------------------------------------------------------------------------------
+
+// Player step (m_Push = false) or box push from cell m_From in direction m_Dir
+struct Move {
+    int m_From;
+    Direction m_Dir;
+    bool m_Push;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class Level {
+public:
+    Level() : m_Columns(0), m_Rows(0), m_Width(0), m_Height(0), m_Player(-1) {}
+
+    // Problem file in the form of sokoban1.pddl: objects ordered by inc, wall/box/at facts, goal of box facts
+    bool loadPddl(const string & path, string & error);
+
+    // Board rows in XSB notation (see print), floor outside the walls becomes wall, coordinates are v1, v2, ...
+    bool loadXsb(const vector<string> & rows, string & error);
+
+    // Equivalent problem for sokoban.pddl in the form of sokoban1.pddl
+    void writePddl(ostream & out, const string & name) const;
+
+    int getWidth() const { return m_Width; }
+    int getCellCount() const { return m_Width * m_Height; }
+    int getBoxCount() const { return m_Boxes.size(); }
+
+    int cellOf(int x, int y) const { return (y + 1) * m_Width + x + 1; }
+    int xOf(int cell) const { return cell % m_Width - 1; }
+    int yOf(int cell) const { return cell / m_Width - 1; }
+
+    int offset(Direction dir) const {
+        return dir == LEFT ? -1 : dir == RIGHT ? 1 : dir == UP ? -m_Width : m_Width;
+    }
+
+    bool isWall(int cell) const { return m_Walls[cell]; }
+    bool isGoal(int cell) const { return m_Goals[cell]; }
+
+    // Initial state, boxes sorted
+    int getPlayer() const { return m_Player; }
+    const vector<int> & getBoxes() const { return m_Boxes; }
+    const vector<int> & getGoalCells() const { return m_GoalCells; }
+
+    // Action in PDDL syntax, e.g. (step-left v4 v2 v3) or (move-box-right v2 v2 v3 v4)
+    string formatMove(const Move & move) const;
+
+    static const char * directionName(Direction dir);
+
+    void print(ostream & out) const;
+
+private:
+    string coordName(int coord) const { return m_Names[coord]; }
+
+    // Size without the border
+    int m_Columns;
+    int m_Rows;
+
+    // Size with the border
+    int m_Width;
+    int m_Height;
+
+    vector<string> m_Names;
+    vector<uint8_t> m_Walls;
+    vector<uint8_t> m_Goals;
+    vector<int> m_GoalCells;
+    vector<int> m_Boxes;
+    int m_Player;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline const char * Level::directionName(Direction dir) {
+    static const char * names[] = {"left", "right", "up", "down"};
+    return names[dir];
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool Level::loadPddl(const string & path, string & error) {
+    SExpr root;
+    if(!PddlReader::readFile(path, root) || root.head() != "define") {
+        error = "cannot read PDDL problem " + path;
+        return false;
+    }
+
+    const SExpr * objects = root.find(":objects");
+    const SExpr * init = root.find(":init");
+    const SExpr * goal = root.find(":goal");
+
+    if(!objects || !init || !goal || goal->m_List.size() != 2) {
+        error = "problem needs :objects, :init and :goal";
+        return false;
+    }
+
+    // Objects ordered by the inc chain
+    set<string> names;
+    for (size_t i = 1; i < objects->m_List.size(); ++i) {
+        const SExpr & object = objects->m_List[i];
+        if(object.m_Atom == "-") {
+            // Typed object list "v1 v2 - coord", skip the type
+            ++i;
+        } else if(object.isAtom()) {
+            names.insert(object.m_Atom);
+        }
+    }
+
+    map<string, string> next;
+    set<string> hasPrevious;
+    vector<vector<string>> walls, boxes, at;
+
+    for (size_t i = 1; i < init->m_List.size(); ++i) {
+        const SExpr & fact = init->m_List[i];
+        if(fact.m_List.size() != 3 || !fact.m_List[1].isAtom() || !fact.m_List[2].isAtom()) {
+            continue;
+        }
+
+        vector<string> args = {fact.m_List[1].m_Atom, fact.m_List[2].m_Atom};
+        if(fact.head() == "inc") {
+            next[args[0]] = args[1];
+            hasPrevious.insert(args[1]);
+        } else if(fact.head() == "wall") {
+            walls.push_back(args);
+        } else if(fact.head() == "box") {
+            boxes.push_back(args);
+        } else if(fact.head() == "at") {
+            at.push_back(args);
+        }
+    }
+
+    map<string, int> coord;
+    m_Names.clear();
+    for (const auto & name : names) {
+        if(next.count(name) && !hasPrevious.count(name)) {
+            for (string current = name; ; current = next[current]) {
+                coord[current] = m_Names.size();
+                m_Names.push_back(current);
+                if(!next.count(current) || coord.count(next[current])) {
+                    break;
+                }
+            }
+            break;
+        }
+    }
+
+    if(m_Names.size() < 3) {
+        error = "objects are not ordered by an inc chain";
+        return false;
+    }
+
+    m_Columns = m_Rows = m_Names.size();
+    m_Width = m_Columns + 2;
+    m_Height = m_Rows + 2;
+    m_Walls.assign(m_Width * m_Height, 0);
+    m_Goals.assign(m_Width * m_Height, 0);
+    m_GoalCells.clear();
+    m_Boxes.clear();
+    m_Player = -1;
+
+    // Border
+    for (int cell = 0; cell < m_Width * m_Height; ++cell) {
+        int x = cell % m_Width;
+        int y = cell / m_Width;
+        m_Walls[cell] = x == 0 || y == 0 || x == m_Width - 1 || y == m_Height - 1;
+    }
+
+    auto toCell = [&](const vector<string> & args, int & cell) {
+        if(!coord.count(args[0]) || !coord.count(args[1])) {
+            return false;
+        }
+        cell = cellOf(coord[args[0]], coord[args[1]]);
+        return true;
+    };
+
+    int cell;
+    for (const auto & args : walls) {
+        if(!toCell(args, cell)) {
+            error = "wall outside of the grid";
+            return false;
+        }
+        m_Walls[cell] = 1;
+    }
+    for (const auto & args : boxes) {
+        if(!toCell(args, cell)) {
+            error = "box outside of the grid";
+            return false;
+        }
+        m_Boxes.push_back(cell);
+    }
+    if(at.size() != 1 || !toCell(at[0], m_Player)) {
+        error = "exactly one player position expected";
+        return false;
+    }
+
+    // (and (box x y) ...) or a single (box x y)
+    const SExpr & condition = goal->m_List[1];
+    vector<const SExpr *> goalFacts;
+    if(condition.head() == "and") {
+        for (size_t i = 1; i < condition.m_List.size(); ++i) {
+            goalFacts.push_back(&condition.m_List[i]);
+        }
+    } else {
+        goalFacts.push_back(&condition);
+    }
+
+    for (const SExpr * fact : goalFacts) {
+        if(fact->head() != "box" || fact->m_List.size() != 3
+           || !toCell({fact->m_List[1].m_Atom, fact->m_List[2].m_Atom}, cell)) {
+            error = "only (box x y) goals are supported";
+            return false;
+        }
+        m_Goals[cell] = 1;
+        m_GoalCells.push_back(cell);
+    }
+
+    sort(m_Boxes.begin(), m_Boxes.end());
+    sort(m_GoalCells.begin(), m_GoalCells.end());
+
+    if(m_Boxes.size() != m_GoalCells.size()) {
+        error = "number of boxes and goals differ";
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool Level::loadXsb(const vector<string> & rows, string & error) {
+    m_Rows = rows.size();
+    m_Columns = 0;
+    for (const auto & row : rows) {
+        m_Columns = max(m_Columns, (int) row.size());
+    }
+
+    if(m_Rows < 3 || m_Columns < 3) {
+        error = "board is too small";
+        return false;
+    }
+
+    // x and y share the objects of the inc chain
+    m_Names.clear();
+    for (int i = 0; i < max(m_Columns, m_Rows); ++i) {
+        m_Names.push_back("v" + to_string(i + 1));
+    }
+
+    m_Width = m_Columns + 2;
+    m_Height = m_Rows + 2;
+    m_Walls.assign(m_Width * m_Height, 1);
+    m_Goals.assign(m_Width * m_Height, 0);
+    m_GoalCells.clear();
+    m_Boxes.clear();
+    m_Player = -1;
+
+    for (int y = 0; y < m_Rows; ++y) {
+        for (int x = 0; x < m_Columns; ++x) {
+            char c = x < (int) rows[y].size() ? rows[y][x] : ' ';
+            int cell = cellOf(x, y);
+
+            if(c == '#') {
+                continue;
+            }
+            if(string(" -_@+$*.").find(c) == string::npos) {
+                error = string("unknown character '") + c + "'";
+                return false;
+            }
+
+            m_Walls[cell] = 0;
+            if(c == '@' || c == '+') {
+                if(m_Player >= 0) {
+                    error = "exactly one player position expected";
+                    return false;
+                }
+                m_Player = cell;
+            }
+            if(c == '$' || c == '*') {
+                m_Boxes.push_back(cell);
+            }
+            if(c == '.' || c == '*' || c == '+') {
+                m_Goals[cell] = 1;
+                m_GoalCells.push_back(cell);
+            }
+        }
+    }
+
+    if(m_Player < 0) {
+        error = "exactly one player position expected";
+        return false;
+    }
+
+    // Player region with boxes as floor, everything else is outside
+    vector<uint8_t> inside(m_Width * m_Height, 0);
+    vector<int> stack = {m_Player};
+    inside[m_Player] = 1;
+    while (!stack.empty()) {
+        int cell = stack.back();
+        stack.pop_back();
+
+        for (Direction dir : DIRECTIONS) {
+            int next = cell + offset(dir);
+            if(!m_Walls[next] && !inside[next]) {
+                inside[next] = 1;
+                stack.push_back(next);
+            }
+        }
+    }
+
+    for (int cell = 0; cell < m_Width * m_Height; ++cell) {
+        if(m_Walls[cell] || inside[cell]) {
+            continue;
+        }
+        if(m_Goals[cell] || binary_search(m_Boxes.begin(), m_Boxes.end(), cell)) {
+            error = "box or goal outside of the walls";
+            return false;
+        }
+        m_Walls[cell] = 1;
+    }
+
+    if(m_Boxes.size() != m_GoalCells.size()) {
+        error = "number of boxes and goals differ";
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void Level::writePddl(ostream & out, const string & name) const {
+    out << "(define (problem " << name << ")\n"
+        << "    (:domain sokoban)\n"
+        << "    (:objects\n   ";
+    for (const auto & object : m_Names) {
+        out << " " << object;
+    }
+    out << "\n    )\n\n    (:init\n";
+
+    for (size_t i = 0; i + 1 < m_Names.size(); ++i) {
+        out << "    (inc " << m_Names[i] << " " << m_Names[i + 1] << ")\n";
+    }
+    out << "\n";
+    for (size_t i = m_Names.size() - 1; i > 0; --i) {
+        out << "    (dec " << m_Names[i] << " " << m_Names[i - 1] << ")\n";
+    }
+    out << "\n";
+
+    for (int y = 0; y < m_Rows; ++y) {
+        for (int x = 0; x < m_Columns; ++x) {
+            if(m_Walls[cellOf(x, y)]) {
+                out << "    (wall " << coordName(x) << " " << coordName(y) << ")\n";
+            }
+        }
+    }
+    out << "\n";
+
+    for (int box : m_Boxes) {
+        out << "    (box " << coordName(xOf(box)) << " " << coordName(yOf(box)) << ")\n";
+    }
+    out << "\n    (at " << coordName(xOf(m_Player)) << " " << coordName(yOf(m_Player)) << ")\n    )\n\n";
+
+    out << "    (:goal\n        (and";
+    for (size_t i = 0; i < m_GoalCells.size(); ++i) {
+        out << (i ? "\n             " : " ") << "(box " << coordName(xOf(m_GoalCells[i])) << " "
+            << coordName(yOf(m_GoalCells[i])) << ")";
+    }
+    out << "\n        )\n    )\n)\n";
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline string Level::formatMove(const Move & move) const {
+    int x = xOf(move.m_From);
+    int y = yOf(move.m_From);
+    bool horizontal = move.m_Dir == LEFT || move.m_Dir == RIGHT;
+    int step = move.m_Dir == LEFT || move.m_Dir == UP ? -1 : 1;
+    int moving = horizontal ? x : y;
+
+    string action = "(";
+    action += move.m_Push ? "move-box-" : "step-";
+    action += directionName(move.m_Dir);
+    action += " " + coordName(x) + " " + coordName(y) + " " + coordName(moving + step);
+    if(move.m_Push) {
+        action += " " + coordName(moving + 2 * step);
+    }
+
+    return action + ")";
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// XSB notation: # wall, @ player, $ box, . goal, * box on goal, + player on goal
+inline void Level::print(ostream & out) const {
+    for (int y = 0; y < m_Rows; ++y) {
+        for (int x = 0; x < m_Columns; ++x) {
+            int cell = cellOf(x, y);
+            bool box = binary_search(m_Boxes.begin(), m_Boxes.end(), cell);
+
+            if(m_Walls[cell]) out << '#';
+            else if(box) out << (m_Goals[cell] ? '*' : '$');
+            else if(cell == m_Player) out << (m_Goals[cell] ? '+' : '@');
+            else out << (m_Goals[cell] ? '.' : ' ');
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+
+using namespace std;
+
+// Lock-free multi-producer single-consumer queue of nodes linked through their m_Next member
+// (intrusive, the queue allocates nothing). Producers only swap the head, the consumer owns the tail.
+// pop may return nullptr while a producer is in the middle of push, the node shows up on a later pop.
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Node>
+class MpscQueue {
+public:
+    MpscQueue() : m_Head(&m_Stub), m_Tail(&m_Stub) {
+        m_Stub.m_Next.store(nullptr, memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue & operator=(const MpscQueue &) = delete;
+
+    // Any thread
+    void push(Node * node);
+
+    // Consumer thread only
+    Node * pop();
+
+private:
+    Node m_Stub;
+    atomic<Node *> m_Head;
+    Node * m_Tail;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Node>
+void MpscQueue<Node>::push(Node * node) {
+    node->m_Next.store(nullptr, memory_order_relaxed);
+    Node * previous = m_Head.exchange(node, memory_order_acq_rel);
+    previous->m_Next.store(node, memory_order_release);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Node>
+Node * MpscQueue<Node>::pop() {
+    Node * tail = m_Tail;
+    Node * next = tail->m_Next.load(memory_order_acquire);
+
+    if(tail == &m_Stub) {
+        if(!next) {
+            return nullptr;
+        }
+        m_Tail = next;
+        tail = next;
+        next = next->m_Next.load(memory_order_acquire);
+    }
+
+    if(next) {
+        m_Tail = next;
+        return tail;
+    }
+
+    // Last node, or a producer has swapped the head but not linked its node yet
+    if(tail != m_Head.load(memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // Stub goes behind the last node so that the last node can be taken out
+    push(&m_Stub);
+    next = tail->m_Next.load(memory_order_acquire);
+    if(next) {
+        m_Tail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
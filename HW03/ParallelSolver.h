@@ -0,0 +1,383 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+
+#include "Level.h"
+#include "Zobrist.h"
+#include "TranspositionTable.h"
+#include "Heuristic.h"
+#include "PushExpander.h"
+#include "MpscQueue.h"
+#include "Solver.h"
+
+using namespace std;
+
+// Hash-distributed A* (HDA*) over pushes.
+// Every state belongs to one worker thread, chosen by the high bits of its Zobrist key. A worker has its own
+// open list, transposition table and state pool; successors of other workers are sent to their lock-free
+// MPSC inbox. The first goal found is only an upper bound: workers keep going and drop every state with
+// f >= the best goal cost, so the result has the fewest pushes as with PushSolver.
+// Termination: m_Work counts open entries plus messages in flight. It is incremented before a message is
+// sent or a state is opened and decremented only after a state is closed, dropped or pruned, so it reaches
+// zero only when all workers are out of work and no message is on its way.
+
+//--------------------------------------------------------------------------------------------------------
+
+class ParallelSolver {
+public:
+    ParallelSolver(const Level & level, int threads, size_t tableBytes = Solver::DEFAULT_TABLE_BYTES);
+
+    bool solve(vector<Move> & plan);
+
+    void setPruning(bool pruning);
+    void setHeuristic(PushHeuristic heuristic);
+
+    const SolverStats & stats() const { return m_Stats; }
+    const Deadlocks & deadlocks() const { return m_Workers[0]->m_Expander.deadlocks(); }
+
+    int getThreads() const { return m_Workers.size(); }
+
+    // Expanded states and sent messages of one worker
+    unsigned long expandedBy(int worker) const { return m_Workers[worker]->m_Expanded; }
+    unsigned long sentBy(int worker) const { return m_Workers[worker]->m_Sent; }
+
+private:
+    static constexpr uint64_t NO_PARENT = UINT64_MAX;
+    static constexpr int IDLE_YIELDS = 16;
+    static constexpr int MAX_IDLE_SLEEP_US = 256;
+
+    struct OpenEntry {
+        int m_F;
+        int m_H;
+        uint32_t m_G;
+        uint32_t m_State;
+
+        bool operator<(const OpenEntry & other) const {
+            return m_F != other.m_F ? m_F > other.m_F : m_H > other.m_H;
+        }
+    };
+
+    // Successor sent to its owner, parent = (worker << 32) | index.
+    // Messages are recycled: the receiver returns a message to the free queue of its sender, m_State keeps
+    // its capacity, so after the first few rounds sending allocates nothing.
+    struct StateMessage {
+        atomic<StateMessage *> m_Next;
+        int m_From;
+        uint64_t m_Parent;
+        uint64_t m_Key;
+        Push m_Push;
+        uint32_t m_G;
+        int m_H;
+        vector<uint16_t> m_State;
+    };
+
+    struct Worker {
+        Worker(const Level & level, const Zobrist & zobrist, const PushDistances & distances, size_t tableBytes)
+                : m_Expander(level, zobrist, distances), m_Table(tableBytes) {}
+
+        PushExpander m_Expander;
+        TranspositionTable m_Table;
+
+        vector<uint16_t> m_Pool;
+        vector<uint64_t> m_Parent;
+        vector<Push> m_Pushes;
+        vector<uint32_t> m_G;
+        vector<uint64_t> m_Keys;
+
+        priority_queue<OpenEntry> m_Open;
+        MpscQueue<StateMessage> m_Inbox;
+
+        // Messages of this worker returned by the receivers, all of them are owned by m_Messages
+        MpscQueue<StateMessage> m_Free;
+        vector<unique_ptr<StateMessage>> m_Messages;
+
+        unsigned long m_Expanded = 0;
+        unsigned long m_Sent = 0;
+    };
+
+    int owner(uint64_t key) const { return (key >> 40) % m_Workers.size(); }
+
+    // Stores the state in its owner and opens it, false when it is known with the same or lower g
+    bool open(Worker & worker, const uint16_t * s, uint64_t parent, Push push, uint64_t key, uint32_t g, int h);
+
+    void run(int id);
+    void expand(int id, uint32_t current);
+    void release(long count) { m_Work.fetch_sub(count, memory_order_acq_rel); }
+
+    // Idle worker gives the core to the workers with states to expand
+    static void backoff(int idle);
+
+    const Level & m_Level;
+    int m_Stride;
+    Zobrist m_Zobrist;
+    PushDistances m_Distances;
+    vector<unique_ptr<Worker>> m_Workers;
+
+    atomic<long> m_Work;
+    atomic<bool> m_Done;
+
+    // Cost of the best goal so far and its state
+    atomic<int> m_Best;
+    mutex m_GoalMutex;
+    uint64_t m_Goal;
+
+    SolverStats m_Stats;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline ParallelSolver::ParallelSolver(const Level & level, int threads, size_t tableBytes)
+        : m_Level(level), m_Stride(level.getBoxCount() + 1), m_Zobrist(level.getCellCount()), m_Distances(level),
+          m_Work(0), m_Done(false), m_Best(INT_MAX), m_Goal(NO_PARENT) {
+    threads = max(threads, 1);
+    for (int i = 0; i < threads; ++i) {
+        m_Workers.emplace_back(new Worker(level, m_Zobrist, m_Distances, tableBytes / threads));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ParallelSolver::setPruning(bool pruning) {
+    for (auto & worker : m_Workers) {
+        worker->m_Expander.setPruning(pruning);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// NONE gives h = 0, the search is then uniform cost
+inline void ParallelSolver::setHeuristic(PushHeuristic heuristic) {
+    for (auto & worker : m_Workers) {
+        worker->m_Expander.setHeuristic(heuristic);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool ParallelSolver::open(Worker & worker, const uint16_t * s, uint64_t parent, Push push, uint64_t key,
+                                 uint32_t g, int h) {
+    uint32_t index = worker.m_Parent.size();
+    worker.m_Pool.insert(worker.m_Pool.end(), s, s + m_Stride);
+    worker.m_Parent.push_back(parent);
+    worker.m_Pushes.push_back(push);
+    worker.m_G.push_back(g);
+    worker.m_Keys.push_back(key);
+
+    const uint16_t * added = &worker.m_Pool[(size_t) index * m_Stride];
+    auto same = [&](uint32_t known) {
+        return equal(added, added + m_Stride, &worker.m_Pool[(size_t) known * m_Stride]);
+    };
+
+    if(worker.m_Table.insert(key, index, g, same, &index)) {
+        worker.m_Pool.resize(worker.m_Pool.size() - m_Stride);
+        worker.m_Parent.pop_back();
+        worker.m_Pushes.pop_back();
+        worker.m_G.pop_back();
+        worker.m_Keys.pop_back();
+
+        if(g >= worker.m_G[index]) {
+            return false;
+        }
+        worker.m_Parent[index] = parent;
+        worker.m_Pushes[index] = push;
+        worker.m_G[index] = g;
+    }
+
+    worker.m_Open.push(OpenEntry{(int) g + h, h, g, index});
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool ParallelSolver::solve(vector<Move> & plan) {
+    m_Stats = SolverStats();
+    m_Work = 0;
+    m_Done = false;
+    m_Best = INT_MAX;
+    m_Goal = NO_PARENT;
+    plan.clear();
+
+    for (auto & worker : m_Workers) {
+        worker->m_Expander.clearStats();
+        worker->m_Table.clear();
+        worker->m_Pool.clear();
+        worker->m_Parent.clear();
+        worker->m_Pushes.clear();
+        worker->m_G.clear();
+        worker->m_Keys.clear();
+        worker->m_Open = priority_queue<OpenEntry>();
+        worker->m_Expanded = worker->m_Sent = 0;
+    }
+
+    auto start = chrono::steady_clock::now();
+
+    vector<uint16_t> initial;
+    PushExpander & expander = m_Workers[0]->m_Expander;
+    expander.initial(initial);
+    uint64_t key = expander.key(initial.data());
+    int h = expander.evaluate(initial.data());
+
+    if(h < PushDistances::INFINITE) {
+        m_Work = 1;
+        open(*m_Workers[owner(key)], initial.data(), NO_PARENT, Push{0, LEFT}, key, 0, h);
+
+        vector<thread> threads;
+        for (size_t i = 0; i < m_Workers.size(); ++i) {
+            threads.emplace_back(&ParallelSolver::run, this, i);
+        }
+        for (auto & t : threads) {
+            t.join();
+        }
+    }
+
+    bool solved = m_Goal != NO_PARENT;
+    if(solved) {
+        vector<Push> pushes;
+        for (uint64_t id = m_Goal; ; ) {
+            Worker & worker = *m_Workers[id >> 32];
+            uint32_t index = id & UINT32_MAX;
+            if(worker.m_Parent[index] == NO_PARENT) {
+                break;
+            }
+            pushes.push_back(worker.m_Pushes[index]);
+            id = worker.m_Parent[index];
+        }
+        reverse(pushes.begin(), pushes.end());
+        expander.buildPlan(pushes, plan);
+    }
+
+    for (auto & worker : m_Workers) {
+        const SolverStats & local = worker->m_Expander.stats();
+        m_Stats.expanded += worker->m_Expanded;
+        m_Stats.generated += local.generated;
+        m_Stats.deadSquarePushes += local.deadSquarePushes;
+        m_Stats.freezePushes += local.freezePushes;
+        m_Stats.states += worker->m_Parent.size();
+    }
+    m_Stats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    return solved;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ParallelSolver::backoff(int idle) {
+    if(idle < IDLE_YIELDS) {
+        this_thread::yield();
+    } else {
+        int shift = min(idle - IDLE_YIELDS, 8);
+        this_thread::sleep_for(chrono::microseconds(min(1 << shift, MAX_IDLE_SLEEP_US)));
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ParallelSolver::run(int id) {
+    Worker & worker = *m_Workers[id];
+
+    // Rounds in a row without work: first only yield, then sleep 1, 2, 4, ... up to MAX_IDLE_SLEEP_US
+    int idle = 0;
+
+    while (!m_Done.load(memory_order_acquire)) {
+        // States sent by the other workers, a received state stays counted when it is opened
+        while (StateMessage * message = worker.m_Inbox.pop()) {
+            bool opened = (int) message->m_G + message->m_H < m_Best.load(memory_order_relaxed)
+                          && open(worker, message->m_State.data(), message->m_Parent, message->m_Push,
+                                  message->m_Key, message->m_G, message->m_H);
+            if(!opened) {
+                release(1);
+            }
+            m_Workers[message->m_From]->m_Free.push(message);
+        }
+
+        if(worker.m_Open.empty()) {
+            if(m_Work.load(memory_order_acquire) == 0) {
+                m_Done.store(true, memory_order_release);
+            } else {
+                backoff(idle++);
+            }
+            continue;
+        }
+        idle = 0;
+
+        OpenEntry entry = worker.m_Open.top();
+        worker.m_Open.pop();
+
+        // Reopened with a lower g or no better than the best goal
+        if(entry.m_G != worker.m_G[entry.m_State] || entry.m_F >= m_Best.load(memory_order_relaxed)) {
+            release(1);
+            continue;
+        }
+
+        expand(id, entry.m_State);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void ParallelSolver::expand(int id, uint32_t current) {
+    Worker & worker = *m_Workers[id];
+    const uint16_t * s = &worker.m_Pool[(size_t) current * m_Stride];
+    uint32_t g = worker.m_G[current] + 1;
+
+    if(worker.m_Expander.isSolved(s)) {
+        lock_guard<mutex> lock(m_GoalMutex);
+        if((int) g - 1 < m_Best.load()) {
+            m_Best.store(g - 1);
+            m_Goal = ((uint64_t) id << 32) | current;
+        }
+        release(1);
+        return;
+    }
+
+    worker.m_Expanded++;
+    worker.m_Expander.evaluate(s);
+    uint64_t parent = ((uint64_t) id << 32) | current;
+
+    // The expanded state stays counted until the end, so m_Work cannot reach zero meanwhile
+    long opened = 0;
+    worker.m_Expander.expand(s, worker.m_Keys[current], [&](const Push & push, int row, const uint16_t * next,
+                                                            uint64_t key) {
+        int h = worker.m_Expander.childHeuristic(push, row);
+        if(h >= PushDistances::INFINITE || (int) g + h >= m_Best.load(memory_order_relaxed)) {
+            return true;
+        }
+
+        int to = owner(key);
+        if(to == id) {
+            opened += open(worker, next, parent, push, key, g, h);
+            return true;
+        }
+
+        StateMessage * message = worker.m_Free.pop();
+        if(!message) {
+            worker.m_Messages.emplace_back(new StateMessage);
+            message = worker.m_Messages.back().get();
+            message->m_From = id;
+        }
+
+        message->m_Parent = parent;
+        message->m_Key = key;
+        message->m_Push = push;
+        message->m_G = g;
+        message->m_H = h;
+        message->m_State.assign(next, next + m_Stride);
+
+        m_Work.fetch_add(1, memory_order_acq_rel);
+        m_Workers[to]->m_Inbox.push(message);
+        worker.m_Sent++;
+        return true;
+    });
+
+    m_Work.fetch_add(opened - 1, memory_order_acq_rel);
+}
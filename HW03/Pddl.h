@@ -0,0 +1,142 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cctype>
+
+using namespace std;
+
+// Minimal PDDL reader - the file is read as a tree of s-expressions.
+// Comments (';' to the end of line) are skipped and everything is lowercased, PDDL is case-insensitive.
+
+//--------------------------------------------------------------------------------------------------------
+
+struct SExpr {
+    // Atom (non-empty m_Atom) or list (m_List)
+    string m_Atom;
+    vector<SExpr> m_List;
+
+    bool isAtom() const { return !m_Atom.empty(); }
+    bool isList() const { return m_Atom.empty(); }
+
+    // Head of a list, e.g. "define", ":init", "and" - empty for atoms and empty lists
+    const string & head() const {
+        static const string empty;
+        return isList() && !m_List.empty() && m_List[0].isAtom() ? m_List[0].m_Atom : empty;
+    }
+
+    // First sub-list with the given head, nullptr when there is none
+    const SExpr * find(const string & name) const {
+        for (const auto & item : m_List) {
+            if(item.head() == name) {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class PddlReader {
+public:
+    // Whole file as one expression, false when the parentheses do not match
+    static bool readFile(const string & path, SExpr & expr);
+    static bool read(const string & text, SExpr & expr);
+
+private:
+    static void tokenize(const string & text, vector<string> & tokens);
+    static bool parse(const vector<string> & tokens, size_t & pos, SExpr & expr);
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PddlReader::readFile(const string & path, SExpr & expr) {
+    ifstream in(path);
+    if(!in) {
+        return false;
+    }
+
+    stringstream text;
+    text << in.rdbuf();
+
+    return read(text.str(), expr);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PddlReader::read(const string & text, SExpr & expr) {
+    vector<string> tokens;
+    tokenize(text, tokens);
+
+    size_t pos = 0;
+    if(!parse(tokens, pos, expr)) {
+        return false;
+    }
+
+    // Only one top level expression
+    return pos == tokens.size();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void PddlReader::tokenize(const string & text, vector<string> & tokens) {
+    string token;
+
+    auto flush = [&]() {
+        if(!token.empty()) {
+            tokens.push_back(token);
+            token.clear();
+        }
+    };
+
+    for (size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+
+        if(c == ';') {
+            flush();
+            while (i < text.size() && text[i] != '\n') {
+                ++i;
+            }
+        } else if(c == '(' || c == ')') {
+            flush();
+            tokens.push_back(string(1, c));
+        } else if(isspace((unsigned char) c)) {
+            flush();
+        } else {
+            token += (char) tolower((unsigned char) c);
+        }
+    }
+    flush();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PddlReader::parse(const vector<string> & tokens, size_t & pos, SExpr & expr) {
+    if(pos >= tokens.size() || tokens[pos] == ")") {
+        return false;
+    }
+
+    if(tokens[pos] != "(") {
+        expr.m_Atom = tokens[pos++];
+        return true;
+    }
+
+    ++pos;
+    while (pos < tokens.size() && tokens[pos] != ")") {
+        expr.m_List.emplace_back();
+        if(!parse(tokens, pos, expr.m_List.back())) {
+            return false;
+        }
+    }
+
+    if(pos >= tokens.size()) {
+        return false;
+    }
+
+    ++pos;
+    return true;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cctype>
+#include <cstdint>
+
+#include "Strips.h"
+
+using namespace std;
+
+// Replays a plan against a grounded task, the state is the packed bitset of StripsTask.
+// Accepts both stored plan formats: LAMA "(step-up v2 v3 v2)" and Delfi "step-up v2 v3 v2 (1)",
+// lines starting with ';' are comments (e.g. "; cost = 9 (unit cost)").
+
+//--------------------------------------------------------------------------------------------------------
+
+struct PlanReport {
+    // Every action applicable and the goal holds at the end
+    bool valid = false;
+    int length = 0;
+    int pushes = 0;
+
+    // 1-based line of the first bad action, 0 when the actions are fine
+    int line = 0;
+    string error;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class PlanValidator {
+public:
+    PlanValidator(const StripsTask & task);
+
+    bool validate(istream & in, PlanReport & report) const;
+    bool validateFile(const string & path, PlanReport & report) const;
+
+    // "(name arg ...)" in lower case with single spaces, empty for comments and blank lines
+    static string normalize(const string & line);
+
+private:
+    const StripsTask & m_Task;
+    unordered_map<string, int> m_Actions;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline PlanValidator::PlanValidator(const StripsTask & task) : m_Task(task) {
+    for (int i = 0; i < task.getActionCount(); ++i) {
+        m_Actions.emplace(task.action(i).m_Name, i);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline string PlanValidator::normalize(const string & line) {
+    string text;
+    for (char c : line) {
+        text += tolower((unsigned char) c);
+    }
+
+    size_t first = text.find_first_not_of(" \t\r");
+    if(first == string::npos || text[first] == ';') {
+        return "";
+    }
+    text.erase(0, first);
+
+    // Delfi: the cost in parentheses follows the action
+    if(text[0] != '(') {
+        size_t cost = text.find('(');
+        if(cost != string::npos) {
+            text.erase(cost);
+        }
+    }
+
+    for (char & c : text) {
+        if(c == '(' || c == ')') {
+            c = ' ';
+        }
+    }
+
+    istringstream tokens(text);
+    string token;
+    string action;
+    while (tokens >> token) {
+        action += action.empty() ? "(" : " ";
+        action += token;
+    }
+
+    return action.empty() ? "" : action + ")";
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PlanValidator::validate(istream & in, PlanReport & report) const {
+    report = PlanReport();
+
+    vector<uint64_t> state = m_Task.getInit();
+    vector<uint64_t> next(state.size());
+
+    string line;
+    for (int number = 1; getline(in, line); ++number) {
+        string name = normalize(line);
+        if(name.empty()) {
+            continue;
+        }
+
+        auto it = m_Actions.find(name);
+        if(it == m_Actions.end()) {
+            report.line = number;
+            report.error = "unknown action " + name;
+            return false;
+        }
+        if(!m_Task.isApplicable(state.data(), it->second)) {
+            report.line = number;
+            report.error = "not applicable " + name;
+            return false;
+        }
+
+        m_Task.apply(state.data(), it->second, next.data());
+        state.swap(next);
+
+        report.length++;
+        report.pushes += name.compare(0, 9, "(move-box") == 0;
+    }
+
+    if(!m_Task.isGoal(state.data())) {
+        report.error = "goal not reached";
+        return false;
+    }
+
+    report.valid = true;
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PlanValidator::validateFile(const string & path, PlanReport & report) const {
+    ifstream in(path);
+    if(!in) {
+        report = PlanReport();
+        report.error = "cannot open " + path;
+        return false;
+    }
+
+    return validate(in, report);
+}
@@ -0,0 +1,354 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "Level.h"
+#include "Zobrist.h"
+#include "Deadlocks.h"
+#include "Heuristic.h"
+#include "Solver.h"
+
+using namespace std;
+
+// Successor generation of the push-level search (see PushSolver).
+// A state is [smallest cell of the player region, sorted box cells]. All buffers used while expanding
+// a state (box map, reachability bitmap, matching of the parent) are here, one instance per search thread.
+
+//--------------------------------------------------------------------------------------------------------
+
+// Box on cell m_Box pushed in direction m_Dir
+struct Push {
+    uint16_t m_Box;
+    Direction m_Dir;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class PushExpander {
+public:
+    PushExpander(const Level & level, const Zobrist & zobrist, const PushDistances & distances);
+
+    void setPruning(bool pruning) { m_Pruning = pruning; }
+    void setHeuristic(PushHeuristic heuristic) { m_Heuristic = heuristic; }
+
+    int getStride() const { return m_Stride; }
+
+    // Initial state of the level
+    void initial(vector<uint16_t> & state);
+    uint64_t key(const uint16_t * s) const { return m_Zobrist.key(s[0], s + 1, m_Stride - 1); }
+
+    bool isSolved(const uint16_t * s) const;
+
+    // Heuristic of a whole state (0 for NONE), its children are then evaluated by childHeuristic
+    int evaluate(const uint16_t * s);
+
+    // Heuristic of the child of the last evaluated state, only the pushed box changed
+    int childHeuristic(const Push & push, int row);
+
+    // Calls visit(push, row of the pushed box, successor, key) for every push of s, stops when it returns false.
+    // key is the key of s kept by the caller, the successor keys are derived from it.
+    // The successor is valid only during the call.
+    template <typename Visit>
+    void expand(const uint16_t * s, uint64_t key, Visit visit);
+
+    // Steps and pushes of the plan replayed from the initial state
+    void buildPlan(const vector<Push> & pushes, vector<Move> & plan);
+
+    // Generated successors and pruned pushes
+    const SolverStats & stats() const { return m_Stats; }
+    void clearStats() { m_Stats = SolverStats(); }
+
+    const Deadlocks & deadlocks() const { return m_Deadlocks; }
+
+private:
+    // Player region from cell with the boxes of m_BoxMap marked in m_Reach, returns its smallest cell
+    int reach(int from);
+    bool isReachable(int cell) const { return (m_Reach[cell >> 6] >> (cell & 63)) & 1; }
+
+    bool isDeadPush(int cell, int offset);
+
+    // Pushes of the state expanded now, player region in m_Reach
+    void findPushes(const uint16_t * s, vector<Push> & pushes);
+
+    // Shortest walk around the boxes of m_BoxMap
+    bool walk(int from, int to, vector<Move> & plan);
+
+    const Level & m_Level;
+    const Zobrist & m_Zobrist;
+    const PushDistances & m_Distances;
+    int m_Stride;
+
+    // Own copy, the freeze check marks cells while it runs
+    Deadlocks m_Deadlocks;
+    bool m_Pruning;
+
+    PushHeuristic m_Heuristic;
+    Matching m_Matching;
+    Matching m_ChildMatching;
+    int m_ParentH;
+
+    vector<uint8_t> m_BoxMap;
+    vector<uint64_t> m_Reach;
+    vector<int> m_Stack;
+    vector<uint16_t> m_Current;
+    vector<uint16_t> m_Next;
+    vector<Push> m_Candidates;
+
+    // Walk: previous cell of the shortest path, -1 = not visited
+    vector<int> m_From;
+
+    SolverStats m_Stats;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline PushExpander::PushExpander(const Level & level, const Zobrist & zobrist, const PushDistances & distances)
+        : m_Level(level), m_Zobrist(zobrist), m_Distances(distances), m_Stride(level.getBoxCount() + 1),
+          m_Deadlocks(level), m_Pruning(true), m_Heuristic(PushHeuristic::NONE),
+          m_Matching(distances, level.getBoxCount()), m_ChildMatching(distances, level.getBoxCount()),
+          m_ParentH(0), m_BoxMap(level.getCellCount(), 0), m_Reach((level.getCellCount() + 63) / 64, 0),
+          m_From(level.getCellCount(), -1) {}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void PushExpander::initial(vector<uint16_t> & state) {
+    state.assign(1, 0);
+    for (int box : m_Level.getBoxes()) {
+        state.push_back(box);
+        m_BoxMap[box] = 1;
+    }
+
+    state[0] = reach(m_Level.getPlayer());
+
+    for (int box : m_Level.getBoxes()) {
+        m_BoxMap[box] = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int PushExpander::reach(int from) {
+    fill(m_Reach.begin(), m_Reach.end(), 0);
+    m_Reach[from >> 6] |= 1ULL << (from & 63);
+    m_Stack.assign(1, from);
+    int smallest = from;
+
+    while (!m_Stack.empty()) {
+        int cell = m_Stack.back();
+        m_Stack.pop_back();
+
+        for (Direction dir : DIRECTIONS) {
+            int next = cell + m_Level.offset(dir);
+            if(m_Level.isWall(next) || m_BoxMap[next] || isReachable(next)) {
+                continue;
+            }
+
+            m_Reach[next >> 6] |= 1ULL << (next & 63);
+            m_Stack.push_back(next);
+            smallest = min(smallest, next);
+        }
+    }
+
+    return smallest;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PushExpander::isSolved(const uint16_t * s) const {
+    for (int i = 1; i < m_Stride; ++i) {
+        if(!m_Level.isGoal(s[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Same as Solver::isDeadPush
+inline bool PushExpander::isDeadPush(int cell, int offset) {
+    int target = cell + offset;
+
+    if(m_Deadlocks.isDeadSquare(target)) {
+        m_Stats.deadSquarePushes++;
+        return true;
+    }
+
+    m_BoxMap[cell] = 0;
+    m_BoxMap[target] = 1;
+    bool frozen = m_Deadlocks.isFreezeDeadlock(target, m_BoxMap.data());
+    m_BoxMap[target] = 0;
+    m_BoxMap[cell] = 1;
+
+    if(frozen) {
+        m_Stats.freezePushes++;
+    }
+    return frozen;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void PushExpander::findPushes(const uint16_t * s, vector<Push> & pushes) {
+    pushes.clear();
+
+    for (int i = 1; i < m_Stride; ++i) {
+        int box = s[i];
+        for (Direction dir : DIRECTIONS) {
+            int offset = m_Level.offset(dir);
+            int target = box + offset;
+
+            if(!isReachable(box - offset) || m_Level.isWall(target) || m_BoxMap[target]) {
+                continue;
+            }
+            if(m_Pruning && isDeadPush(box, offset)) {
+                continue;
+            }
+
+            pushes.push_back(Push{(uint16_t) box, dir});
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int PushExpander::evaluate(const uint16_t * s) {
+    if(m_Heuristic == PushHeuristic::MATCHING) {
+        m_ParentH = m_Matching.solve(s + 1);
+    } else if(m_Heuristic == PushHeuristic::NEAREST) {
+        m_ParentH = 0;
+        for (int i = 1; i < m_Stride; ++i) {
+            m_ParentH += m_Distances.nearest(s[i]);
+        }
+        m_ParentH = min(m_ParentH, PushDistances::INFINITE);
+    } else {
+        m_ParentH = 0;
+    }
+
+    return m_ParentH;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int PushExpander::childHeuristic(const Push & push, int row) {
+    int target = push.m_Box + m_Level.offset(push.m_Dir);
+
+    if(m_Heuristic == PushHeuristic::MATCHING) {
+        m_ChildMatching = m_Matching;
+        return m_ChildMatching.moveBox(row, target);
+    }
+    if(m_Heuristic == PushHeuristic::NEAREST) {
+        return min(m_ParentH - m_Distances.nearest(push.m_Box) + m_Distances.nearest(target), PushDistances::INFINITE);
+    }
+    return 0;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Visit>
+void PushExpander::expand(const uint16_t * s, uint64_t currentKey, Visit visit) {
+    // s may move when visit stores states
+    m_Current.assign(s, s + m_Stride);
+
+    for (int i = 1; i < m_Stride; ++i) {
+        m_BoxMap[m_Current[i]] = 1;
+    }
+
+    int player = m_Current[0];
+    reach(player);
+    findPushes(m_Current.data(), m_Candidates);
+
+    for (const Push & push : m_Candidates) {
+        int offset = m_Level.offset(push.m_Dir);
+        int target = push.m_Box + offset;
+
+        m_Next = m_Current;
+        uint16_t * next = m_Next.data();
+        uint16_t * box = find(next + 1, next + m_Stride, push.m_Box);
+        int row = box - (next + 1);
+
+        *box = target;
+        while (box > next + 1 && box[-1] > box[0]) {
+            swap(box[-1], box[0]);
+            --box;
+        }
+        while (box + 1 < next + m_Stride && box[1] < box[0]) {
+            swap(box[1], box[0]);
+            ++box;
+        }
+
+        // Player stands where the box was
+        m_BoxMap[push.m_Box] = 0;
+        m_BoxMap[target] = 1;
+        next[0] = reach(push.m_Box);
+        m_BoxMap[target] = 0;
+        m_BoxMap[push.m_Box] = 1;
+
+        uint64_t nextKey = currentKey ^ m_Zobrist.box(push.m_Box) ^ m_Zobrist.box(target)
+                           ^ m_Zobrist.player(player) ^ m_Zobrist.player(next[0]);
+
+        m_Stats.generated++;
+        if(!visit(push, row, (const uint16_t *) next, nextKey)) {
+            break;
+        }
+    }
+
+    for (int i = 1; i < m_Stride; ++i) {
+        m_BoxMap[m_Current[i]] = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void PushExpander::buildPlan(const vector<Push> & pushes, vector<Move> & plan) {
+    for (int box : m_Level.getBoxes()) {
+        m_BoxMap[box] = 1;
+    }
+
+    int player = m_Level.getPlayer();
+    for (const Push & push : pushes) {
+        int offset = m_Level.offset(push.m_Dir);
+        walk(player, push.m_Box - offset, plan);
+        plan.push_back(Move{push.m_Box - offset, push.m_Dir, true});
+
+        m_BoxMap[push.m_Box] = 0;
+        m_BoxMap[push.m_Box + offset] = 1;
+        player = push.m_Box;
+    }
+
+    fill(m_BoxMap.begin(), m_BoxMap.end(), 0);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PushExpander::walk(int from, int to, vector<Move> & plan) {
+    fill(m_From.begin(), m_From.end(), -1);
+    m_From[from] = from;
+
+    // m_Stack used as a FIFO queue
+    m_Stack.assign(1, from);
+    for (size_t i = 0; i < m_Stack.size() && m_From[to] < 0; ++i) {
+        for (Direction dir : DIRECTIONS) {
+            int next = m_Stack[i] + m_Level.offset(dir);
+            if(!m_Level.isWall(next) && !m_BoxMap[next] && m_From[next] < 0) {
+                m_From[next] = m_Stack[i];
+                m_Stack.push_back(next);
+            }
+        }
+    }
+
+    if(m_From[to] < 0) {
+        return false;
+    }
+
+    vector<Move> steps;
+    for (int cell = to; cell != from; cell = m_From[cell]) {
+        int previous = m_From[cell];
+        Direction dir = cell - previous == 1 ? RIGHT : cell - previous == -1 ? LEFT : cell > previous ? DOWN : UP;
+        steps.push_back(Move{previous, dir, false});
+    }
+
+    plan.insert(plan.end(), steps.rbegin(), steps.rend());
+    return true;
+}
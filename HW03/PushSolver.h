@@ -0,0 +1,252 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+#include "Level.h"
+#include "Zobrist.h"
+#include "TranspositionTable.h"
+#include "Heuristic.h"
+#include "PushExpander.h"
+#include "Solver.h"
+
+using namespace std;
+
+// Sokoban search over box pushes only.
+// Player steps between pushes do not create states: a state is the set of boxes plus the region the player
+// can walk to, stored as the smallest cell of the region (found by a flood fill over a visited bitmap).
+// Breadth-first search over pushes gives a plan with the fewest pushes, the player steps between them
+// are found by a shortest walk only when the final plan is built.
+// With a heuristic the search is A* over pushes, still with the fewest pushes (see Heuristic.h).
+
+//--------------------------------------------------------------------------------------------------------
+
+class PushSolver {
+public:
+    PushSolver(const Level & level, size_t tableBytes = Solver::DEFAULT_TABLE_BYTES);
+
+    // Plan of steps and pushes, false when the level has no solution
+    bool solve(vector<Move> & plan);
+
+    void setPruning(bool pruning) { m_Expander.setPruning(pruning); }
+
+    // NONE = breadth-first search, otherwise A*
+    void setHeuristic(PushHeuristic heuristic) {
+        m_Heuristic = heuristic;
+        m_Expander.setHeuristic(heuristic);
+    }
+
+    const SolverStats & stats() const { return m_Stats; }
+    const TranspositionTable & table() const { return m_Table; }
+    const Deadlocks & deadlocks() const { return m_Expander.deadlocks(); }
+
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    struct OpenEntry {
+        int m_F;
+        int m_H;
+        uint32_t m_G;
+        uint32_t m_State;
+
+        // Smallest f first, ties by smaller h
+        bool operator<(const OpenEntry & other) const {
+            return m_F != other.m_F ? m_F > other.m_F : m_H > other.m_H;
+        }
+    };
+
+    const uint16_t * state(uint32_t index) const { return &m_Pool[index * m_Stride]; }
+
+    // Appends the state, false when it was already known, index = index of the new or the known state
+    bool addState(const uint16_t * s, uint32_t parent, Push push, uint64_t key, uint32_t g, uint32_t & index);
+
+    bool breadthFirst(uint32_t & goal);
+    bool aStar(uint32_t & goal);
+
+    void buildPlan(uint32_t index, vector<Move> & plan);
+
+    int m_Stride;
+
+    // [smallest player cell, box1, ..., boxK] per state
+    vector<uint16_t> m_Pool;
+    vector<uint32_t> m_Parent;
+    vector<Push> m_Pushes;
+    vector<uint32_t> m_G;
+    vector<uint64_t> m_Keys;
+
+    Zobrist m_Zobrist;
+    TranspositionTable m_Table;
+    PushDistances m_Distances;
+    PushHeuristic m_Heuristic;
+    PushExpander m_Expander;
+
+    SolverStats m_Stats;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline PushSolver::PushSolver(const Level & level, size_t tableBytes)
+        : m_Stride(level.getBoxCount() + 1), m_Zobrist(level.getCellCount()), m_Table(tableBytes),
+          m_Distances(level), m_Heuristic(PushHeuristic::NONE), m_Expander(level, m_Zobrist, m_Distances) {}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PushSolver::addState(const uint16_t * s, uint32_t parent, Push push, uint64_t key, uint32_t g,
+                                 uint32_t & index) {
+    index = m_Parent.size();
+    m_Pool.insert(m_Pool.end(), s, s + m_Stride);
+    m_Parent.push_back(parent);
+    m_Pushes.push_back(push);
+    m_G.push_back(g);
+    m_Keys.push_back(key);
+
+    const uint16_t * added = state(index);
+    auto same = [&](uint32_t known) { return equal(added, added + m_Stride, state(known)); };
+
+    if(m_Table.insert(key, index, g, same, &index)) {
+        m_Pool.resize(m_Pool.size() - m_Stride);
+        m_Parent.pop_back();
+        m_Pushes.pop_back();
+        m_G.pop_back();
+        m_Keys.pop_back();
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PushSolver::solve(vector<Move> & plan) {
+    m_Stats = SolverStats();
+    m_Expander.clearStats();
+    m_Pool.clear();
+    m_Parent.clear();
+    m_Pushes.clear();
+    m_G.clear();
+    m_Keys.clear();
+    m_Table.clear();
+    plan.clear();
+
+    auto start = chrono::steady_clock::now();
+
+    vector<uint16_t> initial;
+    m_Expander.initial(initial);
+
+    uint32_t goal;
+    addState(initial.data(), NO_PARENT, Push{0, LEFT}, m_Expander.key(initial.data()), 0, goal);
+
+    bool solved = m_Heuristic == PushHeuristic::NONE ? breadthFirst(goal) : aStar(goal);
+    if(solved) {
+        buildPlan(goal, plan);
+    }
+
+    const SolverStats & expander = m_Expander.stats();
+    m_Stats.generated = expander.generated;
+    m_Stats.deadSquarePushes = expander.deadSquarePushes;
+    m_Stats.freezePushes = expander.freezePushes;
+    m_Stats.states = m_Parent.size();
+    m_Stats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    return solved;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// States are appended in breadth-first order, so the pool itself is the queue
+inline bool PushSolver::breadthFirst(uint32_t & goal) {
+    if(m_Expander.isSolved(state(0))) {
+        goal = 0;
+        return true;
+    }
+
+    bool solved = false;
+    for (uint32_t current = 0; !solved && current < m_Parent.size(); ++current) {
+        m_Stats.expanded++;
+
+        m_Expander.expand(state(current), m_Keys[current], [&](const Push & push, int, const uint16_t * next,
+                                                                uint64_t key) {
+            uint32_t index;
+            if(addState(next, current, push, key, m_G[current] + 1, index) && m_Expander.isSolved(next)) {
+                solved = true;
+                goal = index;
+            }
+            return !solved;
+        });
+    }
+
+    return solved;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool PushSolver::aStar(uint32_t & goal) {
+    priority_queue<OpenEntry> open;
+
+    int h = m_Expander.evaluate(state(0));
+    if(h >= PushDistances::INFINITE) {
+        return false;
+    }
+    open.push(OpenEntry{h, h, 0, 0});
+
+    while (!open.empty()) {
+        OpenEntry entry = open.top();
+        open.pop();
+
+        uint32_t current = entry.m_State;
+
+        // Reached again by fewer pushes later
+        if(entry.m_G != m_G[current]) {
+            continue;
+        }
+
+        if(m_Expander.isSolved(state(current))) {
+            goal = current;
+            return true;
+        }
+
+        m_Stats.expanded++;
+
+        // Children only change one box of the parent
+        m_Expander.evaluate(state(current));
+
+        m_Expander.expand(state(current), m_Keys[current], [&](const Push & push, int row, const uint16_t * next,
+                                                                uint64_t key) {
+            uint32_t g = m_G[current] + 1;
+            uint32_t index;
+
+            if(!addState(next, current, push, key, g, index)) {
+                if(g >= m_G[index]) {
+                    return true;
+                }
+                m_Parent[index] = current;
+                m_Pushes[index] = push;
+                m_G[index] = g;
+            }
+
+            int childH = m_Expander.childHeuristic(push, row);
+            if(childH < PushDistances::INFINITE) {
+                open.push(OpenEntry{(int) g + childH, childH, g, index});
+            }
+            return true;
+        });
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void PushSolver::buildPlan(uint32_t index, vector<Move> & plan) {
+    vector<Push> pushes;
+    for (; m_Parent[index] != NO_PARENT; index = m_Parent[index]) {
+        pushes.push_back(m_Pushes[index]);
+    }
+    reverse(pushes.begin(), pushes.end());
+
+    m_Expander.buildPlan(pushes, plan);
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+#include "Level.h"
+#include "Zobrist.h"
+#include "TranspositionTable.h"
+#include "Deadlocks.h"
+
+using namespace std;
+
+// Native Sokoban solver.
+// State = player cell + sorted box cells, all states are stored one after another in one uint16_t pool,
+// a state is just its index. Breadth-first search over single player steps and pushes, so the plan has
+// the minimal number of actions (the unit cost the PDDL planners minimise too).
+// Duplicates are found by the Zobrist key of the state (kept with the state and updated by the move,
+// never recomputed) in a transposition table of a fixed size; the table keeps the deepest states, older
+// layers are behind the search frontier and are rarely reached again.
+// Pushes onto dead squares and pushes that freeze a box off a goal are never generated (see Deadlocks).
+
+//--------------------------------------------------------------------------------------------------------
+
+struct SolverStats {
+    unsigned long expanded = 0;
+    unsigned long generated = 0;
+    size_t states = 0;
+
+    // Search time, clearing the transposition table before the search is not counted
+    double ms = 0;
+
+    // Pushes not generated because of a deadlock
+    unsigned long deadSquarePushes = 0;
+    unsigned long freezePushes = 0;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class Solver {
+public:
+    static constexpr size_t DEFAULT_TABLE_BYTES = 256 << 20;
+
+    Solver(const Level & level, size_t tableBytes = DEFAULT_TABLE_BYTES);
+
+    // false when the level has no solution
+    bool solve(vector<Move> & plan);
+
+    // Deadlock pruning, on by default
+    void setPruning(bool pruning) { m_Pruning = pruning; }
+
+    const SolverStats & stats() const { return m_Stats; }
+    const TranspositionTable & table() const { return m_Table; }
+    const Deadlocks & deadlocks() const { return m_Deadlocks; }
+
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    const uint16_t * state(uint32_t index) const { return &m_Pool[index * m_Stride]; }
+
+    // Appends a state to the pool, removes it again when it was already known
+    bool addState(uint32_t parent, Move move, uint64_t key, uint32_t depth);
+
+    bool isSolved(const uint16_t * boxes) const;
+
+    // Box on cell pushed to cell + offset ends in a deadlock
+    bool isDeadPush(int cell, int offset);
+    void buildPlan(uint32_t index, vector<Move> & plan) const;
+
+    const Level & m_Level;
+    int m_Stride;
+
+    // [player, box1, ..., boxK] per state
+    vector<uint16_t> m_Pool;
+    vector<uint32_t> m_Parent;
+    vector<Move> m_Moves;
+    vector<uint64_t> m_Keys;
+    Zobrist m_Zobrist;
+    TranspositionTable m_Table;
+    Deadlocks m_Deadlocks;
+    bool m_Pruning;
+
+    // Boxes of the expanded state
+    vector<uint8_t> m_BoxMap;
+    vector<uint16_t> m_Next;
+
+    SolverStats m_Stats;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline Solver::Solver(const Level & level, size_t tableBytes)
+        : m_Level(level), m_Stride(level.getBoxCount() + 1), m_Zobrist(level.getCellCount()), m_Table(tableBytes),
+          m_Deadlocks(level), m_Pruning(true), m_BoxMap(level.getCellCount(), 0) {}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool Solver::isSolved(const uint16_t * boxes) const {
+    for (int i = 0; i < m_Stride - 1; ++i) {
+        if(!m_Level.isGoal(boxes[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool Solver::isDeadPush(int cell, int offset) {
+    int target = cell + offset;
+
+    if(m_Deadlocks.isDeadSquare(target)) {
+        m_Stats.deadSquarePushes++;
+        return true;
+    }
+
+    m_BoxMap[cell] = 0;
+    m_BoxMap[target] = 1;
+    bool frozen = m_Deadlocks.isFreezeDeadlock(target, m_BoxMap.data());
+    m_BoxMap[target] = 0;
+    m_BoxMap[cell] = 1;
+
+    if(frozen) {
+        m_Stats.freezePushes++;
+    }
+    return frozen;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool Solver::addState(uint32_t parent, Move move, uint64_t key, uint32_t depth) {
+    uint32_t index = m_Parent.size();
+    m_Parent.push_back(parent);
+    m_Moves.push_back(move);
+    m_Keys.push_back(key);
+
+    const uint16_t * s = state(index);
+    auto same = [&](uint32_t known) { return equal(s, s + m_Stride, state(known)); };
+
+    if(m_Table.insert(key, index, depth, same)) {
+        m_Pool.resize(m_Pool.size() - m_Stride);
+        m_Parent.pop_back();
+        m_Moves.pop_back();
+        m_Keys.pop_back();
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool Solver::solve(vector<Move> & plan) {
+    m_Stats = SolverStats();
+    m_Pool.clear();
+    m_Parent.clear();
+    m_Moves.clear();
+    m_Keys.clear();
+    m_Table.clear();
+    plan.clear();
+
+    auto start = chrono::steady_clock::now();
+
+    m_Pool.push_back(m_Level.getPlayer());
+    for (int box : m_Level.getBoxes()) {
+        m_Pool.push_back(box);
+    }
+    addState(NO_PARENT, Move{0, LEFT, false}, m_Zobrist.key(state(0)[0], state(0) + 1, m_Stride - 1), 0);
+
+    bool solved = isSolved(state(0) + 1);
+    uint32_t goal = 0;
+
+    // States are appended in breadth-first order, so the pool itself is the queue
+    uint32_t depth = 0;
+    uint32_t layerEnd = 1;
+    for (uint32_t current = 0; !solved && current < m_Parent.size(); ++current) {
+        if(current == layerEnd) {
+            depth++;
+            layerEnd = m_Parent.size();
+        }
+        m_Stats.expanded++;
+
+        int player = state(current)[0];
+        uint64_t key = m_Keys[current];
+        for (int i = 1; i < m_Stride; ++i) {
+            m_BoxMap[state(current)[i]] = 1;
+        }
+
+        for (Direction dir : DIRECTIONS) {
+            int offset = m_Level.offset(dir);
+            int next = player + offset;
+
+            if(m_Level.isWall(next)) {
+                continue;
+            }
+
+            bool push = m_BoxMap[next];
+            if(push && (m_Level.isWall(next + offset) || m_BoxMap[next + offset])) {
+                continue;
+            }
+
+            if(push && m_Pruning && isDeadPush(next, offset)) {
+                continue;
+            }
+
+            // Successor with boxes kept sorted, then appended to the pool
+            m_Next.assign(state(current), state(current) + m_Stride);
+            uint16_t * s = m_Next.data();
+            s[0] = next;
+            uint64_t nextKey = key ^ m_Zobrist.player(player) ^ m_Zobrist.player(next);
+
+            if(push) {
+                nextKey ^= m_Zobrist.box(next) ^ m_Zobrist.box(next + offset);
+                uint16_t * box = find(s + 1, s + m_Stride, next);
+                *box = next + offset;
+                while (box > s + 1 && box[-1] > box[0]) {
+                    swap(box[-1], box[0]);
+                    --box;
+                }
+                while (box + 1 < s + m_Stride && box[1] < box[0]) {
+                    swap(box[1], box[0]);
+                    ++box;
+                }
+            }
+
+            m_Pool.insert(m_Pool.end(), m_Next.begin(), m_Next.end());
+            m_Stats.generated++;
+            if(addState(current, Move{player, dir, push}, nextKey, depth + 1) && push && isSolved(state(m_Parent.size() - 1) + 1)) {
+                solved = true;
+                goal = m_Parent.size() - 1;
+                break;
+            }
+        }
+
+        for (int i = 1; i < m_Stride; ++i) {
+            m_BoxMap[state(current)[i]] = 0;
+        }
+    }
+
+    if(solved) {
+        buildPlan(goal, plan);
+    }
+
+    m_Stats.states = m_Parent.size();
+    m_Stats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    return solved;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void Solver::buildPlan(uint32_t index, vector<Move> & plan) const {
+    for (; m_Parent[index] != NO_PARENT; index = m_Parent[index]) {
+        plan.push_back(m_Moves[index]);
+    }
+    reverse(plan.begin(), plan.end());
+}
@@ -0,0 +1,554 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+#include <algorithm>
+
+#include "Pddl.h"
+
+using namespace std;
+
+// Grounded STRIPS task.
+// Every action schema of the domain is instantiated with all objects of the problem. Static predicates
+// (never changed by an effect, e.g. inc, dec, wall) are evaluated during grounding and do not become facts.
+// The remaining facts are bits of a packed state, every ground action has precondition, negative
+// precondition, add and delete masks, so applicability and successors are just word operations.
+
+//--------------------------------------------------------------------------------------------------------
+
+struct GroundAction {
+    // e.g. (step-up v2 v3 v2)
+    string m_Name;
+
+    // Fact indices, masks are built from them
+    vector<int> m_Pre;
+    vector<int> m_Neg;
+    vector<int> m_Add;
+    vector<int> m_Del;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class StripsTask {
+public:
+    StripsTask() : m_Words(0) {}
+
+    bool load(const string & domainPath, const string & problemPath, string & error);
+
+    int getWords() const { return m_Words; }
+    int getFactCount() const { return m_FactNames.size(); }
+    int getActionCount() const { return m_Actions.size(); }
+
+    const string & factName(int fact) const { return m_FactNames[fact]; }
+    const GroundAction & action(int index) const { return m_Actions[index]; }
+
+    // Masks of an action, m_Words words each
+    const uint64_t * pre(int action) const { return &m_Masks[(4 * action + 0) * m_Words]; }
+    const uint64_t * neg(int action) const { return &m_Masks[(4 * action + 1) * m_Words]; }
+    const uint64_t * add(int action) const { return &m_Masks[(4 * action + 2) * m_Words]; }
+    const uint64_t * del(int action) const { return &m_Masks[(4 * action + 3) * m_Words]; }
+
+    const vector<uint64_t> & getInit() const { return m_Init; }
+    const vector<int> & getGoalFacts() const { return m_GoalFacts; }
+
+    bool isApplicable(const uint64_t * state, int action) const;
+
+    // next = (state & ~del) | add
+    void apply(const uint64_t * state, int action, uint64_t * next) const;
+
+    bool isGoal(const uint64_t * state) const;
+
+    static bool testBit(const uint64_t * state, int fact) { return (state[fact >> 6] >> (fact & 63)) & 1; }
+
+private:
+    // Argument >= 0 is a parameter of the schema, < 0 is object -(arg + 1)
+    struct Literal {
+        int m_Predicate;
+        vector<int> m_Args;
+        bool m_Negated;
+    };
+
+    struct Schema {
+        string m_Name;
+        vector<string> m_Params;
+        vector<Literal> m_Pre;
+        vector<Literal> m_Effect;
+
+        // Static preconditions checked as soon as their last parameter is bound (index = parameters bound)
+        vector<vector<int>> m_CheckAt;
+    };
+
+    bool parseSchema(const SExpr & expr, Schema & schema, string & error);
+    bool parseLiterals(const SExpr & expr, const Schema & schema, vector<Literal> & literals, string & error);
+    bool parseAtom(const SExpr & expr, const Schema & schema, Literal & literal, string & error);
+    bool parseFact(const SExpr & expr, vector<int> & fact, string & error);
+
+    int predicateIndex(const string & name);
+    int factIndex(const vector<int> & fact);
+
+    // Predicate and objects of a literal under the binding
+    vector<int> bind(const Literal & literal, const vector<int> & binding) const;
+    bool holdsStatic(const Literal & literal, const vector<int> & binding) const;
+
+    void ground(const Schema & schema, vector<int> & binding, size_t bound);
+    void instantiate(const Schema & schema, const vector<int> & binding);
+
+    // Drops actions not reachable in the delete relaxation
+    void pruneUnreachable();
+    void buildMasks();
+
+    vector<string> m_Objects;
+    map<string, int> m_ObjectIndex;
+    vector<string> m_Predicates;
+    map<string, int> m_PredicateIndex;
+    vector<bool> m_Static;
+    set<vector<int>> m_StaticFacts;
+    vector<Schema> m_Schemas;
+
+    vector<string> m_FactNames;
+    map<vector<int>, int> m_FactIndex;
+    vector<int> m_InitFacts;
+    vector<int> m_GoalFacts;
+    bool m_StaticGoalFailed = false;
+
+    vector<GroundAction> m_Actions;
+    int m_Words;
+    vector<uint64_t> m_Masks;
+    vector<uint64_t> m_Init;
+    vector<uint64_t> m_Goal;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsTask::load(const string & domainPath, const string & problemPath, string & error) {
+    SExpr domain, problem;
+    if(!PddlReader::readFile(domainPath, domain) || domain.head() != "define") {
+        error = "cannot read PDDL domain " + domainPath;
+        return false;
+    }
+    if(!PddlReader::readFile(problemPath, problem) || problem.head() != "define") {
+        error = "cannot read PDDL problem " + problemPath;
+        return false;
+    }
+
+    // Objects of the problem and constants of the domain, types are skipped
+    for (const SExpr * list : {domain.find(":constants"), problem.find(":objects")}) {
+        for (size_t i = 1; list && i < list->m_List.size(); ++i) {
+            const SExpr & object = list->m_List[i];
+            if(object.m_Atom == "-") {
+                ++i;
+            } else if(object.isAtom() && !m_ObjectIndex.count(object.m_Atom)) {
+                m_ObjectIndex[object.m_Atom] = m_Objects.size();
+                m_Objects.push_back(object.m_Atom);
+            }
+        }
+    }
+
+    for (const auto & item : domain.m_List) {
+        if(item.head() == ":action") {
+            m_Schemas.emplace_back();
+            if(!parseSchema(item, m_Schemas.back(), error)) {
+                return false;
+            }
+        }
+    }
+
+    // Predicate is static when no effect changes it
+    m_Static.assign(m_Predicates.size(), true);
+    for (const auto & schema : m_Schemas) {
+        for (const auto & literal : schema.m_Effect) {
+            m_Static[literal.m_Predicate] = false;
+        }
+    }
+
+    const SExpr * init = problem.find(":init");
+    const SExpr * goal = problem.find(":goal");
+    if(!init || !goal || goal->m_List.size() != 2) {
+        error = "problem needs :init and :goal";
+        return false;
+    }
+
+    vector<int> fact;
+    for (size_t i = 1; i < init->m_List.size(); ++i) {
+        if(!parseFact(init->m_List[i], fact, error)) {
+            return false;
+        }
+        if(m_Static[fact[0]]) {
+            m_StaticFacts.insert(fact);
+        } else {
+            m_InitFacts.push_back(factIndex(fact));
+        }
+    }
+
+    // Conjunction of positive facts
+    const SExpr & condition = goal->m_List[1];
+    vector<const SExpr *> goalFacts;
+    if(condition.head() == "and") {
+        for (size_t i = 1; i < condition.m_List.size(); ++i) {
+            goalFacts.push_back(&condition.m_List[i]);
+        }
+    } else {
+        goalFacts.push_back(&condition);
+    }
+
+    for (const SExpr * expr : goalFacts) {
+        if(!parseFact(*expr, fact, error)) {
+            return false;
+        }
+        if(m_Static[fact[0]]) {
+            m_StaticGoalFailed |= !m_StaticFacts.count(fact);
+        } else {
+            m_GoalFacts.push_back(factIndex(fact));
+        }
+    }
+
+    for (auto & schema : m_Schemas) {
+        // Static preconditions grouped by the number of parameters they need
+        schema.m_CheckAt.assign(schema.m_Params.size() + 1, {});
+        for (size_t i = 0; i < schema.m_Pre.size(); ++i) {
+            const Literal & literal = schema.m_Pre[i];
+            if(!m_Static[literal.m_Predicate]) {
+                continue;
+            }
+            int last = 0;
+            for (int arg : literal.m_Args) {
+                last = max(last, arg + 1);
+            }
+            schema.m_CheckAt[last].push_back(i);
+        }
+
+        vector<int> binding(schema.m_Params.size(), 0);
+        ground(schema, binding, 0);
+    }
+
+    pruneUnreachable();
+    buildMasks();
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int StripsTask::predicateIndex(const string & name) {
+    auto it = m_PredicateIndex.find(name);
+    if(it != m_PredicateIndex.end()) {
+        return it->second;
+    }
+
+    m_PredicateIndex[name] = m_Predicates.size();
+    m_Predicates.push_back(name);
+    return m_Predicates.size() - 1;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int StripsTask::factIndex(const vector<int> & fact) {
+    auto it = m_FactIndex.find(fact);
+    if(it != m_FactIndex.end()) {
+        return it->second;
+    }
+
+    string name = "(" + m_Predicates[fact[0]];
+    for (size_t i = 1; i < fact.size(); ++i) {
+        name += " " + m_Objects[fact[i]];
+    }
+
+    m_FactIndex[fact] = m_FactNames.size();
+    m_FactNames.push_back(name + ")");
+    return m_FactNames.size() - 1;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsTask::parseSchema(const SExpr & expr, Schema & schema, string & error) {
+    if(expr.m_List.size() < 2 || !expr.m_List[1].isAtom()) {
+        error = "action without a name";
+        return false;
+    }
+    schema.m_Name = expr.m_List[1].m_Atom;
+
+    const SExpr * params = nullptr, * pre = nullptr, * effect = nullptr;
+    for (size_t i = 2; i + 1 < expr.m_List.size(); i += 2) {
+        const string & key = expr.m_List[i].m_Atom;
+        if(key == ":parameters") params = &expr.m_List[i + 1];
+        else if(key == ":precondition") pre = &expr.m_List[i + 1];
+        else if(key == ":effect") effect = &expr.m_List[i + 1];
+    }
+
+    for (size_t i = 0; params && i < params->m_List.size(); ++i) {
+        const SExpr & param = params->m_List[i];
+        if(param.m_Atom == "-") {
+            ++i;
+        } else if(param.isAtom()) {
+            schema.m_Params.push_back(param.m_Atom);
+        }
+    }
+
+    if((pre && !parseLiterals(*pre, schema, schema.m_Pre, error))
+       || (effect && !parseLiterals(*effect, schema, schema.m_Effect, error))) {
+        error = schema.m_Name + ": " + error;
+        return false;
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// (and l1 l2 ...), (p ...), (not (p ...)), empty list = no condition
+inline bool StripsTask::parseLiterals(const SExpr & expr, const Schema & schema, vector<Literal> & literals,
+                                      string & error) {
+    if(expr.isList() && expr.m_List.empty()) {
+        return true;
+    }
+
+    if(expr.head() == "and") {
+        for (size_t i = 1; i < expr.m_List.size(); ++i) {
+            if(!parseLiterals(expr.m_List[i], schema, literals, error)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Literal literal;
+    literal.m_Negated = expr.head() == "not";
+    if(!parseAtom(literal.m_Negated && expr.m_List.size() == 2 ? expr.m_List[1] : expr, schema, literal, error)) {
+        return false;
+    }
+
+    literals.push_back(literal);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsTask::parseAtom(const SExpr & expr, const Schema & schema, Literal & literal, string & error) {
+    static const set<string> unsupported = {"not", "and", "or", "imply", "exists", "forall", "when", "="};
+
+    if(expr.head().empty() || unsupported.count(expr.head())) {
+        error = "only STRIPS conditions and effects are supported";
+        return false;
+    }
+
+    literal.m_Predicate = predicateIndex(expr.head());
+    for (size_t i = 1; i < expr.m_List.size(); ++i) {
+        const string & arg = expr.m_List[i].m_Atom;
+        int param = find(schema.m_Params.begin(), schema.m_Params.end(), arg) - schema.m_Params.begin();
+
+        if(param < (int) schema.m_Params.size()) {
+            literal.m_Args.push_back(param);
+        } else if(m_ObjectIndex.count(arg)) {
+            literal.m_Args.push_back(-(m_ObjectIndex[arg] + 1));
+        } else {
+            error = "unknown argument " + arg;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsTask::parseFact(const SExpr & expr, vector<int> & fact, string & error) {
+    fact.clear();
+    if(expr.head().empty() || expr.head() == "not" || expr.head() == "and") {
+        error = "only positive facts are supported in :init and :goal";
+        return false;
+    }
+
+    fact.push_back(predicateIndex(expr.head()));
+    for (size_t i = 1; i < expr.m_List.size(); ++i) {
+        auto it = m_ObjectIndex.find(expr.m_List[i].m_Atom);
+        if(it == m_ObjectIndex.end()) {
+            error = "unknown object " + expr.m_List[i].m_Atom;
+            return false;
+        }
+        fact.push_back(it->second);
+    }
+
+    // Predicates used only in the problem are static
+    if(fact[0] >= (int) m_Static.size()) {
+        m_Static.resize(fact[0] + 1, true);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline vector<int> StripsTask::bind(const Literal & literal, const vector<int> & binding) const {
+    vector<int> fact = {literal.m_Predicate};
+    for (int arg : literal.m_Args) {
+        fact.push_back(arg >= 0 ? binding[arg] : -(arg + 1));
+    }
+    return fact;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsTask::holdsStatic(const Literal & literal, const vector<int> & binding) const {
+    return m_StaticFacts.count(bind(literal, binding)) != (size_t) literal.m_Negated;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void StripsTask::ground(const Schema & schema, vector<int> & binding, size_t bound) {
+    for (int i : schema.m_CheckAt[bound]) {
+        if(!holdsStatic(schema.m_Pre[i], binding)) {
+            return;
+        }
+    }
+
+    if(bound == schema.m_Params.size()) {
+        instantiate(schema, binding);
+        return;
+    }
+
+    for (size_t object = 0; object < m_Objects.size(); ++object) {
+        binding[bound] = object;
+        ground(schema, binding, bound + 1);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void StripsTask::instantiate(const Schema & schema, const vector<int> & binding) {
+    GroundAction action;
+
+    action.m_Name = "(" + schema.m_Name;
+    for (int object : binding) {
+        action.m_Name += " " + m_Objects[object];
+    }
+    action.m_Name += ")";
+
+    for (const auto & literal : schema.m_Pre) {
+        if(!m_Static[literal.m_Predicate]) {
+            (literal.m_Negated ? action.m_Neg : action.m_Pre).push_back(factIndex(bind(literal, binding)));
+        }
+    }
+
+    // Contradicting preconditions
+    for (int fact : action.m_Pre) {
+        if(find(action.m_Neg.begin(), action.m_Neg.end(), fact) != action.m_Neg.end()) {
+            return;
+        }
+    }
+
+    for (const auto & literal : schema.m_Effect) {
+        (literal.m_Negated ? action.m_Del : action.m_Add).push_back(factIndex(bind(literal, binding)));
+    }
+
+    m_Actions.push_back(action);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void StripsTask::pruneUnreachable() {
+    vector<bool> reached(m_FactNames.size(), false);
+    for (int fact : m_InitFacts) {
+        reached[fact] = true;
+    }
+
+    vector<bool> applicable(m_Actions.size(), false);
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (size_t i = 0; i < m_Actions.size(); ++i) {
+            if(applicable[i]) {
+                continue;
+            }
+
+            bool ready = true;
+            for (int fact : m_Actions[i].m_Pre) {
+                ready &= reached[fact];
+            }
+            if(!ready) {
+                continue;
+            }
+
+            applicable[i] = changed = true;
+            for (int fact : m_Actions[i].m_Add) {
+                reached[fact] = true;
+            }
+        }
+    }
+
+    vector<GroundAction> actions;
+    for (size_t i = 0; i < m_Actions.size(); ++i) {
+        if(applicable[i]) {
+            actions.push_back(move(m_Actions[i]));
+        }
+    }
+    m_Actions.swap(actions);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void StripsTask::buildMasks() {
+    m_Words = (m_FactNames.size() + 63) / 64;
+    m_Masks.assign(4 * m_Actions.size() * m_Words, 0);
+
+    auto setBits = [](uint64_t * mask, const vector<int> & facts) {
+        for (int fact : facts) {
+            mask[fact >> 6] |= 1ULL << (fact & 63);
+        }
+    };
+
+    for (size_t i = 0; i < m_Actions.size(); ++i) {
+        setBits(&m_Masks[(4 * i + 0) * m_Words], m_Actions[i].m_Pre);
+        setBits(&m_Masks[(4 * i + 1) * m_Words], m_Actions[i].m_Neg);
+        setBits(&m_Masks[(4 * i + 2) * m_Words], m_Actions[i].m_Add);
+        setBits(&m_Masks[(4 * i + 3) * m_Words], m_Actions[i].m_Del);
+    }
+
+    m_Init.assign(m_Words, 0);
+    m_Goal.assign(m_Words, 0);
+    setBits(m_Init.data(), m_InitFacts);
+    setBits(m_Goal.data(), m_GoalFacts);
+
+    // Unreachable goal, no state satisfies it
+    if(m_StaticGoalFailed) {
+        m_Goal.assign(m_Words, ~0ULL);
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsTask::isApplicable(const uint64_t * state, int action) const {
+    const uint64_t * p = pre(action);
+    const uint64_t * n = neg(action);
+
+    for (int w = 0; w < m_Words; ++w) {
+        if((state[w] & p[w]) != p[w] || (state[w] & n[w])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void StripsTask::apply(const uint64_t * state, int action, uint64_t * next) const {
+    const uint64_t * a = add(action);
+    const uint64_t * d = del(action);
+
+    for (int w = 0; w < m_Words; ++w) {
+        next[w] = (state[w] & ~d[w]) | a[w];
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsTask::isGoal(const uint64_t * state) const {
+    for (int w = 0; w < m_Words; ++w) {
+        if((state[w] & m_Goal[w]) != m_Goal[w]) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,380 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_set>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <algorithm>
+
+#include "Strips.h"
+
+using namespace std;
+
+// Forward search over the packed states of a grounded STRIPS task.
+// States are stored one after another in one pool of m_Words words each, a state is its index.
+// BFS gives a plan with the fewest actions, greedy best-first search uses the number of unsatisfied goals
+// (not admissible, one action may achieve several goals, GBFS does not need it). A* uses hmax (cost of the
+// most expensive goal in the delete relaxation), admissible for unit cost, so its plans are optimal too.
+
+//--------------------------------------------------------------------------------------------------------
+
+enum class SearchMode {
+    BFS,
+    GBFS,
+    ASTAR
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+struct PlannerStats {
+    unsigned long expanded = 0;
+    unsigned long generated = 0;
+    size_t states = 0;
+    double ms = 0;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class StripsPlanner {
+public:
+    StripsPlanner(const StripsTask & task);
+
+    // Plan as indices of ground actions, false when the goal is unreachable
+    bool search(SearchMode mode, vector<int> & plan);
+
+    const PlannerStats & stats() const { return m_Stats; }
+
+    static bool parseMode(const string & name, SearchMode & mode);
+
+private:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+    static constexpr int DEAD_END = INT_MAX;
+
+    struct StateHash {
+        const StripsPlanner * m_Planner;
+        size_t operator()(uint32_t state) const;
+    };
+
+    struct StateEqual {
+        const StripsPlanner * m_Planner;
+        bool operator()(uint32_t a, uint32_t b) const;
+    };
+
+    struct OpenEntry {
+        int m_F;
+        int m_H;
+        int m_G;
+        uint32_t m_State;
+
+        // Smallest f first, ties by smaller h
+        bool operator<(const OpenEntry & other) const {
+            return m_F != other.m_F ? m_F > other.m_F : m_H > other.m_H;
+        }
+    };
+
+    const uint64_t * state(uint32_t index) const { return &m_Pool[(size_t) index * m_Words]; }
+
+    // Appends m_Next as a new state, returns its index or the index of the equal known state
+    uint32_t addState(uint32_t parent, int action, int g, bool & added);
+
+    bool breadthFirst(uint32_t & goal);
+    bool bestFirst(bool astar, uint32_t & goal);
+
+    int heuristic(bool astar, const uint64_t * s);
+    int goalCount(const uint64_t * s) const;
+    int hmax(const uint64_t * s);
+
+    const StripsTask & m_Task;
+    int m_Words;
+
+    vector<uint64_t> m_Pool;
+    vector<uint32_t> m_Parent;
+    vector<int> m_Action;
+    vector<int> m_G;
+    unordered_set<uint32_t, StateHash, StateEqual> m_Visited;
+    vector<uint64_t> m_Next;
+
+    // hmax: actions by precondition fact, counters of unreached preconditions, fact costs
+    vector<vector<int>> m_PreOf;
+    vector<int> m_PreCount;
+    vector<int> m_Remaining;
+    vector<int> m_Cost;
+    vector<uint8_t> m_IsGoal;
+    vector<int> m_Queue;
+
+    PlannerStats m_Stats;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline StripsPlanner::StripsPlanner(const StripsTask & task)
+        : m_Task(task), m_Words(task.getWords()), m_Visited(1024, StateHash{this}, StateEqual{this}),
+          m_Next(task.getWords()), m_PreOf(task.getFactCount()), m_PreCount(task.getActionCount()),
+          m_IsGoal(task.getFactCount(), 0) {
+    for (int a = 0; a < task.getActionCount(); ++a) {
+        for (int fact : task.action(a).m_Pre) {
+            m_PreOf[fact].push_back(a);
+        }
+        m_PreCount[a] = task.action(a).m_Pre.size();
+    }
+    for (int fact : task.getGoalFacts()) {
+        m_IsGoal[fact] = 1;
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsPlanner::parseMode(const string & name, SearchMode & mode) {
+    if(name == "bfs") mode = SearchMode::BFS;
+    else if(name == "gbfs") mode = SearchMode::GBFS;
+    else if(name == "astar") mode = SearchMode::ASTAR;
+    else return false;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline size_t StripsPlanner::StateHash::operator()(uint32_t index) const {
+    const uint64_t * s = m_Planner->state(index);
+    uint64_t hash = 0x9E3779B97F4A7C15ULL;
+
+    for (int w = 0; w < m_Planner->m_Words; ++w) {
+        hash = (hash ^ s[w]) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 31;
+    }
+
+    return hash;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsPlanner::StateEqual::operator()(uint32_t a, uint32_t b) const {
+    return equal(m_Planner->state(a), m_Planner->state(a) + m_Planner->m_Words, m_Planner->state(b));
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline uint32_t StripsPlanner::addState(uint32_t parent, int action, int g, bool & added) {
+    uint32_t index = m_Parent.size();
+    m_Pool.insert(m_Pool.end(), m_Next.begin(), m_Next.end());
+    m_Parent.push_back(parent);
+    m_Action.push_back(action);
+    m_G.push_back(g);
+
+    auto result = m_Visited.insert(index);
+    added = result.second;
+
+    if(!added) {
+        m_Pool.resize(m_Pool.size() - m_Words);
+        m_Parent.pop_back();
+        m_Action.pop_back();
+        m_G.pop_back();
+    }
+
+    return *result.first;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsPlanner::search(SearchMode mode, vector<int> & plan) {
+    auto start = chrono::steady_clock::now();
+
+    m_Stats = PlannerStats();
+    m_Pool.clear();
+    m_Parent.clear();
+    m_Action.clear();
+    m_G.clear();
+    m_Visited.clear();
+    plan.clear();
+
+    m_Next = m_Task.getInit();
+    bool added;
+    addState(NO_PARENT, -1, 0, added);
+
+    uint32_t goal = 0;
+    bool solved = mode == SearchMode::BFS ? breadthFirst(goal) : bestFirst(mode == SearchMode::ASTAR, goal);
+
+    if(solved) {
+        for (; m_Parent[goal] != NO_PARENT; goal = m_Parent[goal]) {
+            plan.push_back(m_Action[goal]);
+        }
+        reverse(plan.begin(), plan.end());
+    }
+
+    m_Stats.states = m_Parent.size();
+    m_Stats.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+    return solved;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// States are appended in breadth-first order, so the pool itself is the queue
+inline bool StripsPlanner::breadthFirst(uint32_t & goal) {
+    if(m_Task.isGoal(state(0))) {
+        goal = 0;
+        return true;
+    }
+
+    for (uint32_t current = 0; current < m_Parent.size(); ++current) {
+        m_Stats.expanded++;
+
+        for (int a = 0; a < m_Task.getActionCount(); ++a) {
+            if(!m_Task.isApplicable(state(current), a)) {
+                continue;
+            }
+
+            m_Task.apply(state(current), a, m_Next.data());
+            m_Stats.generated++;
+
+            bool added;
+            uint32_t index = addState(current, a, m_G[current] + 1, added);
+            if(added && m_Task.isGoal(state(index))) {
+                goal = index;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool StripsPlanner::bestFirst(bool astar, uint32_t & goal) {
+    priority_queue<OpenEntry> open;
+
+    int h = heuristic(astar, state(0));
+    if(h == DEAD_END) {
+        return false;
+    }
+    open.push(OpenEntry{h, h, 0, 0});
+
+    while (!open.empty()) {
+        OpenEntry entry = open.top();
+        open.pop();
+
+        uint32_t current = entry.m_State;
+
+        // Reached again by a cheaper path later
+        if(entry.m_G != m_G[current]) {
+            continue;
+        }
+
+        if(m_Task.isGoal(state(current))) {
+            goal = current;
+            return true;
+        }
+
+        m_Stats.expanded++;
+
+        for (int a = 0; a < m_Task.getActionCount(); ++a) {
+            if(!m_Task.isApplicable(state(current), a)) {
+                continue;
+            }
+
+            m_Task.apply(state(current), a, m_Next.data());
+            m_Stats.generated++;
+
+            int g = m_G[current] + 1;
+            bool added;
+            uint32_t index = addState(current, a, g, added);
+
+            if(!added) {
+                // Only A* reopens states, greedy search keeps the first path
+                if(!astar || g >= m_G[index]) {
+                    continue;
+                }
+                m_Parent[index] = current;
+                m_Action[index] = a;
+                m_G[index] = g;
+            }
+
+            h = heuristic(astar, state(index));
+            if(h != DEAD_END) {
+                open.push(OpenEntry{astar ? g + h : h, h, g, index});
+            }
+        }
+    }
+
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int StripsPlanner::heuristic(bool astar, const uint64_t * s) {
+    return astar ? hmax(s) : goalCount(s);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline int StripsPlanner::goalCount(const uint64_t * s) const {
+    int count = 0;
+    for (int fact : m_Task.getGoalFacts()) {
+        count += !StripsTask::testBit(s, fact);
+    }
+    return count;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Unit costs: facts are reached in non-decreasing cost, an action fires when its last precondition is
+// reached, so its cost is the maximum over the preconditions
+inline int StripsPlanner::hmax(const uint64_t * s) {
+    m_Cost.assign(m_Task.getFactCount(), DEAD_END);
+    m_Remaining = m_PreCount;
+    m_Queue.clear();
+
+    for (int w = 0; w < m_Words; ++w) {
+        for (uint64_t bits = s[w]; bits; bits &= bits - 1) {
+            int fact = w * 64 + __builtin_ctzll(bits);
+            m_Cost[fact] = 0;
+            m_Queue.push_back(fact);
+        }
+    }
+
+    auto fire = [&](int action, int cost) {
+        for (int fact : m_Task.action(action).m_Add) {
+            if(m_Cost[fact] == DEAD_END) {
+                m_Cost[fact] = cost + 1;
+                m_Queue.push_back(fact);
+            }
+        }
+    };
+
+    for (int a = 0; a < m_Task.getActionCount(); ++a) {
+        if(m_PreCount[a] == 0) {
+            fire(a, 0);
+        }
+    }
+
+    int goalsLeft = m_Task.getGoalFacts().size();
+    int result = 0;
+    if(goalsLeft == 0) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < m_Queue.size(); ++i) {
+        int fact = m_Queue[i];
+
+        if(m_IsGoal[fact]) {
+            result = m_Cost[fact];
+            if(--goalsLeft == 0) {
+                return result;
+            }
+        }
+
+        for (int a : m_PreOf[fact]) {
+            if(--m_Remaining[a] == 0) {
+                fire(a, m_Cost[fact]);
+            }
+        }
+    }
+
+    return DEAD_END;
+}
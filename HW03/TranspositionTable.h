@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+// Open-addressing transposition table of a fixed memory budget.
+// Entry = 64-bit key + 32-bit value (state index) + 32-bit priority, 4 entries form one bucket of 64 bytes,
+// a key may be stored only in its own bucket. In a full bucket the entry with the lowest priority is
+// replaced, unless the new one has an even lower priority - then the new entry is not stored at all.
+// A lost entry only means a state may be searched twice, the search stays correct.
+
+//--------------------------------------------------------------------------------------------------------
+
+struct TableStats {
+    unsigned long stored = 0;
+    unsigned long replaced = 0;
+    unsigned long dropped = 0;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class TranspositionTable {
+public:
+    static constexpr int BUCKET = 4;
+    static constexpr uint32_t EMPTY = UINT32_MAX;
+
+    explicit TranspositionTable(size_t budgetBytes);
+
+    void clear();
+
+    // True when an entry with the key and same(value) is stored (its value written to known),
+    // otherwise stores (key, value)
+    template <typename Same>
+    bool insert(uint64_t key, uint32_t value, uint32_t priority, Same same, uint32_t * known = nullptr);
+
+    // Value of the entry with the key and same(value) for in-place update, nullptr when it is not stored
+    template <typename Same>
+    uint32_t * find(uint64_t key, Same same);
+
+    size_t capacity() const { return m_Entries.size(); }
+    size_t bytes() const { return m_Entries.size() * sizeof(Entry); }
+    const TableStats & stats() const { return m_Stats; }
+
+private:
+    struct Entry {
+        uint64_t m_Key;
+        uint32_t m_Value;
+        uint32_t m_Priority;
+    };
+
+    vector<Entry> m_Entries;
+    uint64_t m_BucketMask;
+    TableStats m_Stats;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline TranspositionTable::TranspositionTable(size_t budgetBytes) {
+    // Largest power of two number of buckets within the budget
+    size_t buckets = 1;
+    while (2 * buckets * BUCKET * sizeof(Entry) <= budgetBytes) {
+        buckets *= 2;
+    }
+
+    m_Entries.resize(buckets * BUCKET);
+    m_BucketMask = buckets - 1;
+    clear();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void TranspositionTable::clear() {
+    for (auto & entry : m_Entries) {
+        entry = Entry{0, EMPTY, 0};
+    }
+    m_Stats = TableStats();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Same>
+bool TranspositionTable::insert(uint64_t key, uint32_t value, uint32_t priority, Same same, uint32_t * known) {
+    // Low bits pick the bucket, the whole key is compared
+    Entry * bucket = &m_Entries[(key & m_BucketMask) * BUCKET];
+    Entry * victim = nullptr;
+
+    for (int i = 0; i < BUCKET; ++i) {
+        Entry & entry = bucket[i];
+
+        if(entry.m_Value == EMPTY) {
+            if(!victim || victim->m_Value != EMPTY) {
+                victim = &entry;
+            }
+            continue;
+        }
+
+        if(entry.m_Key == key && same(entry.m_Value)) {
+            if(known) {
+                *known = entry.m_Value;
+            }
+            return true;
+        }
+
+        if(!victim || (victim->m_Value != EMPTY && entry.m_Priority < victim->m_Priority)) {
+            victim = &entry;
+        }
+    }
+
+    if(victim->m_Value == EMPTY) {
+        m_Stats.stored++;
+    } else if(victim->m_Priority <= priority) {
+        m_Stats.replaced++;
+    } else {
+        m_Stats.dropped++;
+        return false;
+    }
+
+    *victim = Entry{key, value, priority};
+    return false;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Same>
+uint32_t * TranspositionTable::find(uint64_t key, Same same) {
+    Entry * bucket = &m_Entries[(key & m_BucketMask) * BUCKET];
+
+    for (int i = 0; i < BUCKET; ++i) {
+        if(bucket[i].m_Value != EMPTY && bucket[i].m_Key == key && same(bucket[i].m_Value)) {
+            return &bucket[i].m_Value;
+        }
+    }
+    return nullptr;
+}
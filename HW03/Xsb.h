@@ -0,0 +1,99 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Reader of Sokoban collections in the XSB text format (# wall, @ player, $ box, . goal, * box on goal,
+// + player on goal, space, '-' or '_' floor). Levels are separated by any non-board lines. The title of
+// a level is a "Title:" line after its board, otherwise the first text line before it ("; 1", "Level 1").
+// Other "Key: value" lines (Author:, Comment:) are skipped.
+
+//--------------------------------------------------------------------------------------------------------
+
+struct XsbLevel {
+    string m_Title;
+    vector<string> m_Rows;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+class XsbReader {
+public:
+    static bool readFile(const string & path, vector<XsbLevel> & levels);
+    static void read(istream & in, vector<XsbLevel> & levels);
+
+    // Only board characters and at least one wall
+    static bool isBoardLine(const string & line);
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool XsbReader::readFile(const string & path, vector<XsbLevel> & levels) {
+    ifstream in(path);
+    if(!in) {
+        return false;
+    }
+
+    read(in, levels);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline bool XsbReader::isBoardLine(const string & line) {
+    return line.find('#') != string::npos && line.find_first_not_of(" #@$.*+-_") == string::npos;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline void XsbReader::read(istream & in, vector<XsbLevel> & levels) {
+    levels.clear();
+
+    string line;
+    string pending;
+    bool inBoard = false;
+
+    while (getline(in, line)) {
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ' || line.back() == '\t')) {
+            line.pop_back();
+        }
+
+        if(isBoardLine(line)) {
+            if(!inBoard) {
+                levels.push_back(XsbLevel{pending, {}});
+                pending.clear();
+                inBoard = true;
+            }
+            levels.back().m_Rows.push_back(line);
+            continue;
+        }
+        inBoard = false;
+
+        size_t start = line.find_first_not_of(" \t;");
+        if(start == string::npos) {
+            continue;
+        }
+        string text = line.substr(start);
+
+        size_t colon = text.find(':');
+        bool field = colon != string::npos && text.find(' ') > colon;
+
+        if(field && text.compare(0, 6, "Title:") == 0) {
+            size_t title = text.find_first_not_of(' ', 6);
+            string & target = levels.empty() ? pending : levels.back().m_Title;
+            target = title == string::npos ? "" : text.substr(title);
+        } else if(!field && pending.empty()) {
+            pending = text;
+        }
+    }
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        if(levels[i].m_Title.empty()) {
+            levels[i].m_Title = "level " + to_string(i + 1);
+        }
+    }
+}
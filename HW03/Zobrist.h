@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <random>
+#include <cstdint>
+
+using namespace std;
+
+// Zobrist keys of a Sokoban state: XOR of one random key per box cell and one per player cell.
+// A move changes the key by XORing out the old cells and XORing in the new ones.
+
+//--------------------------------------------------------------------------------------------------------
+
+class Zobrist {
+public:
+    Zobrist(int cellCount, uint64_t seed = 0x5D588B656C078965ULL);
+
+    uint64_t box(int cell) const { return m_Box[cell]; }
+    uint64_t player(int cell) const { return m_Player[cell]; }
+
+    // Key of a whole state, boxes in any order
+    uint64_t key(int player, const uint16_t * boxes, int boxCount) const;
+
+private:
+    vector<uint64_t> m_Box;
+    vector<uint64_t> m_Player;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+inline Zobrist::Zobrist(int cellCount, uint64_t seed) : m_Box(cellCount), m_Player(cellCount) {
+    mt19937_64 gen(seed);
+    for (int cell = 0; cell < cellCount; ++cell) {
+        m_Box[cell] = gen();
+        m_Player[cell] = gen();
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+inline uint64_t Zobrist::key(int player, const uint16_t * boxes, int boxCount) const {
+    uint64_t key = m_Player[player];
+    for (int i = 0; i < boxCount; ++i) {
+        key ^= m_Box[boxes[i]];
+    }
+    return key;
+}
@@ -0,0 +1,195 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "Level.h"
+#include "Xsb.h"
+#include "PushSolver.h"
+#include "IdaSolver.h"
+#include "Strips.h"
+#include "PlanValidator.h"
+
+using namespace std;
+
+// Solves every level of an XSB collection, e.g. levels/collection.txt.
+// Levels go straight into Level, no PDDL is involved. With --pddl every level is also written as
+// dir/levelK.pddl and the plan is checked against it by PlanValidator.
+// Build: g++ -std=c++17 -O2 batch.cpp -o batch
+
+//--------------------------------------------------------------------------------------------------------
+
+struct BatchOptions {
+    string collectionPath;
+    string domainPath = "sokoban.pddl";
+    string pddlDir;
+    bool ida = false;
+
+    // 0 = default budget of the solver
+    size_t tableBytes = 0;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+struct LevelResult {
+    bool solved = false;
+    int moves = 0;
+    int pushes = 0;
+    SolverStats stats;
+
+    // Checked against the written PDDL problem
+    bool checked = false;
+    bool valid = false;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename SolverType>
+void solveLevel(SolverType & solver, vector<Move> & plan, LevelResult & result) {
+    result.solved = solver.solve(plan);
+    result.stats = solver.stats();
+
+    if(result.solved) {
+        result.moves = plan.size();
+        for (const Move & move : plan) {
+            result.pushes += move.m_Push;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool writeAndValidate(const Level & level, int number, const vector<Move> & plan, const BatchOptions & opts,
+                      LevelResult & result, string & error) {
+    string name = "level" + to_string(number);
+    string path = opts.pddlDir + "/" + name + ".pddl";
+
+    ofstream out(path, ios::out | ios::trunc);
+    if(!out) {
+        error = "cannot write " + path;
+        return false;
+    }
+    level.writePddl(out, name);
+    out.close();
+
+    if(!result.solved) {
+        return true;
+    }
+
+    StripsTask task;
+    if(!task.load(opts.domainPath, path, error)) {
+        return false;
+    }
+
+    stringstream text;
+    for (const Move & move : plan) {
+        text << level.formatMove(move) << "\n";
+    }
+
+    PlanReport report;
+    result.checked = true;
+    result.valid = PlanValidator(task).validate(text, report);
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void printRow(int number, const string & title, const Level & level, const LevelResult & result) {
+    cout << setw(4) << number << "  " << left << setw(20) << title.substr(0, 20) << right
+         << setw(6) << level.getBoxCount();
+
+    if(result.solved) {
+        cout << setw(8) << result.pushes << setw(8) << result.moves;
+    } else {
+        cout << setw(8) << "-" << setw(8) << "-";
+    }
+
+    cout << setw(12) << result.stats.expanded << setw(12) << fixed << setprecision(2) << result.stats.ms
+         << setw(8) << (result.checked ? (result.valid ? "yes" : "no") : "-") << endl;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int main ( int argc, char ** argv ) {
+
+    const char * usage = " levels.txt [--ida] [--tt MB] [--pddl dir] [--domain sokoban.pddl]";
+
+    if(argc < 2) {
+        cout << argv[0] << usage << endl;
+        return EXIT_FAILURE;
+    }
+
+    BatchOptions opts;
+    opts.collectionPath = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        if(string(argv[i]) == "--ida") {
+            opts.ida = true;
+        } else if(string(argv[i]) == "--tt" && i + 1 < argc) {
+            opts.tableBytes = strtoul(argv[++i], nullptr, 10) << 20;
+        } else if(string(argv[i]) == "--pddl" && i + 1 < argc) {
+            opts.pddlDir = argv[++i];
+        } else if(string(argv[i]) == "--domain" && i + 1 < argc) {
+            opts.domainPath = argv[++i];
+        } else {
+            cout << argv[0] << usage << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(opts.tableBytes == 0) {
+        opts.tableBytes = opts.ida ? IdaSolver::DEFAULT_TABLE_BYTES : Solver::DEFAULT_TABLE_BYTES;
+    }
+
+    vector<XsbLevel> levels;
+    if(!XsbReader::readFile(opts.collectionPath, levels)) {
+        cout << "cannot read " << opts.collectionPath << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << setw(4) << "#" << "  " << left << setw(20) << "level" << right << setw(6) << "boxes"
+         << setw(8) << "pushes" << setw(8) << "moves" << setw(12) << "expanded" << setw(12) << "ms"
+         << setw(8) << "valid" << endl;
+
+    int solved = 0;
+    double totalMs = 0;
+    auto start = chrono::steady_clock::now();
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        int number = i + 1;
+        Level level;
+        string error;
+
+        if(!level.loadXsb(levels[i].m_Rows, error)) {
+            cout << setw(4) << number << "  " << levels[i].m_Title << ": " << error << endl;
+            continue;
+        }
+
+        vector<Move> plan;
+        LevelResult result;
+        if(opts.ida) {
+            IdaSolver solver{level, opts.tableBytes};
+            solveLevel(solver, plan, result);
+        } else {
+            PushSolver solver{level, opts.tableBytes};
+            solver.setHeuristic(PushHeuristic::MATCHING);
+            solveLevel(solver, plan, result);
+        }
+
+        if(!opts.pddlDir.empty() && !writeAndValidate(level, number, plan, opts, result, error)) {
+            cout << setw(4) << number << "  " << levels[i].m_Title << ": " << error << endl;
+        }
+
+        printRow(number, levels[i].m_Title, level, result);
+        solved += result.solved;
+        totalMs += result.stats.ms;
+    }
+
+    cout << "; solved " << solved << " / " << levels.size() << ", search " << totalMs << " ms, total "
+         << chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+
+    return solved == (int) levels.size() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,167 @@
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Level.h"
+#include "Solver.h"
+#include "PushSolver.h"
+#include "Strips.h"
+#include "PlanValidator.h"
+
+using namespace std;
+
+// Native solvers against the stored external plans of each level.
+// For sokobanK.pddl the stored plans are LAMAsokobanK.txt and DelfiSokobanK.txt next to it. Every plan,
+// native or stored, is replayed by PlanValidator, so the lengths and pushes come from the same check.
+// Native wall time is the median search time over the runs (SolverStats::ms, without clearing the table),
+// the external planners did not record theirs.
+// Build: g++ -std=c++17 -O2 benchmark.cpp -o benchmark
+
+//--------------------------------------------------------------------------------------------------------
+
+struct BenchmarkOptions {
+    string domainPath = "sokoban.pddl";
+    vector<string> levels;
+    int runs = 3;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+void printHeader() {
+    cout << left << setw(16) << "level" << setw(12) << "planner" << right << setw(8) << "valid"
+         << setw(10) << "length" << setw(10) << "pushes" << setw(14) << "median ms" << endl;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void printRow(const string & level, const string & planner, const PlanReport & report, double ms) {
+    cout << left << setw(16) << level << setw(12) << planner << right << setw(8) << (report.valid ? "yes" : "no")
+         << setw(10) << report.length << setw(10) << report.pushes << setw(14);
+
+    if(ms < 0) {
+        cout << "-";
+    } else {
+        cout << fixed << setprecision(2) << ms;
+    }
+
+    if(!report.valid) {
+        cout << "  " << (report.line ? "line " + to_string(report.line) + ": " : "") << report.error;
+    }
+    cout << endl;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Median solve time over the runs, the plan of the last run is validated
+template <typename SolverType>
+void benchmarkSolver(const string & levelName, const string & name, const Level & level, SolverType & solver,
+                     const PlanValidator & validator, const BenchmarkOptions & opts) {
+    vector<double> ms;
+    vector<Move> plan;
+    bool solved = false;
+
+    for (int i = 0; i < opts.runs; ++i) {
+        solved = solver.solve(plan);
+        ms.push_back(solver.stats().ms);
+    }
+    sort(ms.begin(), ms.end());
+
+    PlanReport report;
+    if(solved) {
+        stringstream text;
+        for (const Move & move : plan) {
+            text << level.formatMove(move) << "\n";
+        }
+        validator.validate(text, report);
+    } else {
+        report.error = "no solution";
+    }
+
+    printRow(levelName, name, report, ms[ms.size() / 2]);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// sokobanK.pddl -> prefixsokobanK.txt, "Sokoban" in the Delfi names
+string storedPlanPath(const string & problemPath, const string & prefix, bool capital) {
+    size_t slash = problemPath.find_last_of('/');
+    string dir = slash == string::npos ? "" : problemPath.substr(0, slash + 1);
+    string name = problemPath.substr(dir.size());
+    name = name.substr(0, name.rfind('.'));
+
+    if(capital && !name.empty()) {
+        name[0] = toupper((unsigned char) name[0]);
+    }
+
+    return dir + prefix + name + ".txt";
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool benchmarkLevel(const string & problemPath, const BenchmarkOptions & opts) {
+    Level level;
+    StripsTask task;
+    string error;
+
+    if(!level.loadPddl(problemPath, error) || !task.load(opts.domainPath, problemPath, error)) {
+        cout << problemPath << ": " << error << endl;
+        return false;
+    }
+
+    PlanValidator validator{task};
+    string name = problemPath.substr(problemPath.find_last_of('/') + 1);
+
+    Solver stepSolver{level};
+    benchmarkSolver(name, "step bfs", level, stepSolver, validator, opts);
+
+    PushSolver pushSolver{level};
+    pushSolver.setHeuristic(PushHeuristic::MATCHING);
+    benchmarkSolver(name, "push a*", level, pushSolver, validator, opts);
+
+    for (const auto & stored : {make_pair(string("lama"), storedPlanPath(problemPath, "LAMA", false)),
+                                make_pair(string("delfi"), storedPlanPath(problemPath, "Delfi", true))}) {
+        PlanReport report;
+        validator.validateFile(stored.second, report);
+        printRow(name, stored.first, report, -1);
+    }
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int main ( int argc, char ** argv ) {
+
+    const char * usage = " [--domain sokoban.pddl] [--runs R] [problem.pddl ...]";
+
+    BenchmarkOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        if(string(argv[i]) == "--domain" && i + 1 < argc) {
+            opts.domainPath = argv[++i];
+        } else if(string(argv[i]) == "--runs" && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            opts.runs = atoi(argv[++i]);
+        } else if(argv[i][0] != '-') {
+            opts.levels.push_back(argv[i]);
+        } else {
+            cout << argv[0] << usage << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    if(opts.levels.empty()) {
+        opts.levels = {"sokoban1.pddl", "sokoban2.pddl"};
+    }
+
+    printHeader();
+    bool ok = true;
+    for (const string & path : opts.levels) {
+        ok = benchmarkLevel(path, opts) && ok;
+    }
+
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
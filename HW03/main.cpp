@@ -0,0 +1,149 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Level.h"
+#include "Solver.h"
+#include "PushSolver.h"
+#include "ParallelSolver.h"
+#include "IdaSolver.h"
+
+using namespace std;
+
+//--------------------------------------------------------------------------------------------------------
+
+// Solves the level and prints the plan in the same form as the stored LAMA plans
+template <typename SolverType>
+bool run(const Level & level, SolverType & solver) {
+    vector<Move> plan;
+    bool solved = solver.solve(plan);
+
+    if(solved) {
+        int pushes = 0;
+        for (const Move & move : plan) {
+            cout << level.formatMove(move) << "\n";
+            pushes += move.m_Push;
+        }
+        cout << "; cost = " << plan.size() << " (unit cost), pushes " << pushes << endl;
+    } else {
+        cout << "; no solution" << endl;
+    }
+
+    const SolverStats & stats = solver.stats();
+    cout << "; expanded " << stats.expanded << ", generated " << stats.generated << ", states " << stats.states
+         << ", " << stats.ms << " ms" << endl;
+
+    cout << "; dead squares " << solver.deadlocks().getDeadSquareCount() << ", pruned pushes: dead square "
+         << stats.deadSquarePushes << ", freeze " << stats.freezePushes << endl;
+
+    return solved;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+void printTable(const TranspositionTable & table) {
+    const TableStats & stats = table.stats();
+    cout << "; table " << (table.bytes() >> 20) << " MB, stored " << stats.stored << ", replaced "
+         << stats.replaced << ", dropped " << stats.dropped << endl;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+bool parseHeuristic(const string & name, PushHeuristic & heuristic) {
+    if(name == "none") heuristic = PushHeuristic::NONE;
+    else if(name == "nearest") heuristic = PushHeuristic::NEAREST;
+    else if(name == "matching") heuristic = PushHeuristic::MATCHING;
+    else return false;
+
+    return true;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+int main ( int argc, char ** argv ) {
+
+    const char * usage = " problem.pddl [--push] [--heuristic none|nearest|matching] [--ida] [--threads N] [--tt MB] [--no-pruning]";
+
+    if(argc < 2) {
+        cout << argv[0] << usage << endl;
+        return EXIT_FAILURE;
+    }
+
+    // 0 = default budget of the chosen solver
+    size_t tableBytes = 0;
+    bool pruning = true;
+    bool pushLevel = false;
+    bool ida = false;
+    bool heuristicSet = false;
+    PushHeuristic heuristic = PushHeuristic::NONE;
+    int threads = 0;
+    for (int i = 2; i < argc; ++i) {
+        if(string(argv[i]) == "--tt" && i + 1 < argc) {
+            tableBytes = strtoul(argv[++i], nullptr, 10) << 20;
+        } else if(string(argv[i]) == "--no-pruning") {
+            pruning = false;
+        } else if(string(argv[i]) == "--push") {
+            pushLevel = true;
+        } else if(string(argv[i]) == "--heuristic" && i + 1 < argc && parseHeuristic(argv[i + 1], heuristic)) {
+            pushLevel = heuristicSet = true;
+            ++i;
+        } else if(string(argv[i]) == "--ida") {
+            ida = true;
+        } else if(string(argv[i]) == "--threads" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else {
+            cout << argv[0] << usage << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Level level;
+    string error;
+    if(!level.loadPddl(argv[1], error)) {
+        cout << argv[1] << ": " << error << endl;
+        return EXIT_FAILURE;
+    }
+
+    level.print(cout);
+    cout << endl;
+
+    if(tableBytes == 0) {
+        tableBytes = ida ? IdaSolver::DEFAULT_TABLE_BYTES : Solver::DEFAULT_TABLE_BYTES;
+    }
+
+    bool solved;
+    if(ida) {
+        // Without a heuristic IDA* would be plain iterative deepening, matching is the default
+        IdaSolver solver{level, tableBytes};
+        solver.setPruning(pruning);
+        if(heuristicSet) {
+            solver.setHeuristic(heuristic);
+        }
+        solved = run(level, solver);
+        cout << "; iterations " << solver.getIterations() << endl;
+        printTable(solver.table());
+    } else if(threads > 0) {
+        ParallelSolver solver{level, threads, tableBytes};
+        solver.setPruning(pruning);
+        solver.setHeuristic(heuristic);
+        solved = run(level, solver);
+
+        for (int i = 0; i < solver.getThreads(); ++i) {
+            cout << "; worker " << i << ": expanded " << solver.expandedBy(i) << ", sent " << solver.sentBy(i) << endl;
+        }
+    } else if(pushLevel) {
+        PushSolver solver{level, tableBytes};
+        solver.setPruning(pruning);
+        solver.setHeuristic(heuristic);
+        solved = run(level, solver);
+        printTable(solver.table());
+    } else {
+        Solver solver{level, tableBytes};
+        solver.setPruning(pruning);
+        solved = run(level, solver);
+        printTable(solver.table());
+    }
+
+    return solved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "Strips.h"
+#include "StripsPlanner.h"
+
+using namespace std;
+
+//--------------------------------------------------------------------------------------------------------
+
+int main ( int argc, char ** argv ) {
+
+    const char * usage = " domain.pddl problem.pddl [bfs|gbfs|astar]";
+
+    SearchMode mode = SearchMode::ASTAR;
+    if(argc < 3 || (argc > 3 && !StripsPlanner::parseMode(argv[3], mode))) {
+        cout << argv[0] << usage << endl;
+        return EXIT_FAILURE;
+    }
+
+    StripsTask task;
+    string error;
+    if(!task.load(argv[1], argv[2], error)) {
+        cout << error << endl;
+        return EXIT_FAILURE;
+    }
+
+    cout << "; " << task.getFactCount() << " facts (" << task.getWords() << " words), "
+         << task.getActionCount() << " ground actions" << endl;
+
+    StripsPlanner planner{task};
+    vector<int> plan;
+    bool solved = planner.search(mode, plan);
+
+    if(solved) {
+        for (int action : plan) {
+            cout << task.action(action).m_Name << "\n";
+        }
+        cout << "; cost = " << plan.size() << " (unit cost)" << endl;
+    } else {
+        cout << "; no solution" << endl;
+    }
+
+    const PlannerStats & stats = planner.stats();
+    cout << "; expanded " << stats.expanded << ", generated " << stats.generated << ", states " << stats.states
+         << ", " << stats.ms << " ms" << endl;
+
+    return solved ? EXIT_SUCCESS : EXIT_FAILURE;
+}
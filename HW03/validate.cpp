@@ -0,0 +1,45 @@
+#include <iostream>
+#include <cstdlib>
+#include <string>
+
+#include "Strips.h"
+#include "PlanValidator.h"
+
+using namespace std;
+
+//--------------------------------------------------------------------------------------------------------
+
+int main ( int argc, char ** argv ) {
+
+    const char * usage = " domain.pddl problem.pddl plan.txt [plan.txt ...]";
+
+    if(argc < 4) {
+        cout << argv[0] << usage << endl;
+        return EXIT_FAILURE;
+    }
+
+    StripsTask task;
+    string error;
+    if(!task.load(argv[1], argv[2], error)) {
+        cout << error << endl;
+        return EXIT_FAILURE;
+    }
+
+    PlanValidator validator{task};
+    bool allValid = true;
+
+    for (int i = 3; i < argc; ++i) {
+        PlanReport report;
+        bool valid = validator.validateFile(argv[i], report);
+        allValid = allValid && valid;
+
+        cout << argv[i] << ": " << (valid ? "valid" : "invalid") << ", length " << report.length
+             << ", pushes " << report.pushes;
+        if(!valid) {
+            cout << ", " << (report.line ? "line " + to_string(report.line) + ": " : "") << report.error;
+        }
+        cout << endl;
+    }
+
+    return allValid ? EXIT_SUCCESS : EXIT_FAILURE;
+}
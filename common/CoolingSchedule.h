@@ -0,0 +1,160 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+using namespace std;
+
+// Cooling schedules shared by the N-queens (HW02) and Sudoku (semestralWork) annealers.
+// Annealer asks for temperature() before every step and reports the step with update(),
+// which returns false when the run should terminate.
+// delta = newScore - oldScore (lower is better), accepted = whether the move was kept.
+
+//--------------------------------------------------------------------------------------------------------
+
+// Fixed geometric cooling, terminates after stagnationLimit steps without improvement
+class GeometricSchedule {
+public:
+    GeometricSchedule(double temp, double coolingRate, int stagnationLimit)
+            : m_Temp(temp), m_CoolingRate(coolingRate), m_StagnationLimit(stagnationLimit), m_LastImprovement(0) {}
+
+    double temperature() const { return m_Temp; }
+    string name() const { return "geometric"; }
+
+    bool update(int delta, bool accepted) {
+        (void) accepted;
+
+        if(delta >= 0) {
+            m_LastImprovement++;
+        } else {
+            m_LastImprovement = 0;
+        }
+
+        m_Temp = m_Temp * m_CoolingRate;
+
+        return m_LastImprovement < m_StagnationLimit;
+    }
+
+protected:
+    double m_Temp;
+    double m_CoolingRate;
+    int m_StagnationLimit;
+
+    // Iterations without improvement
+    int m_LastImprovement;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+// Keeps acceptance ratio of worsening moves close to targetAcceptance.
+// After every window of worsening moves the temperature is lowered when too many of them were accepted
+// and raised when too few were, so the start temperature does not have to be tuned per problem size.
+// The target itself is multiplied by targetDecay after every window, so the search slowly turns greedy.
+class AdaptiveSchedule {
+public:
+    AdaptiveSchedule(double temp, double targetAcceptance, int window, int stagnationLimit,
+                     double targetDecay = 0.95, double adjustRate = 0.9)
+            : m_Temp(temp), m_TargetAcceptance(targetAcceptance), m_Window(window), m_StagnationLimit(stagnationLimit),
+              m_TargetDecay(targetDecay), m_AdjustRate(adjustRate), m_LastImprovement(0), m_Worsening(0),
+              m_WorseningAccepted(0) {}
+
+    double temperature() const { return m_Temp; }
+    string name() const { return "adaptive"; }
+
+    bool update(int delta, bool accepted) {
+        if(delta >= 0) {
+            m_LastImprovement++;
+        } else {
+            m_LastImprovement = 0;
+        }
+
+        if(delta > 0) {
+            m_Worsening++;
+            if(accepted) {
+                m_WorseningAccepted++;
+            }
+        }
+
+        if(m_Worsening >= m_Window) {
+            double ratio = (double) m_WorseningAccepted / m_Worsening;
+
+            // Heat only while the target still means at least one accepted move per window,
+            // afterwards an empty window is what we want and the schedule just keeps cooling
+            if(ratio > m_TargetAcceptance) {
+                m_Temp = m_Temp * m_AdjustRate;
+            } else if(ratio < m_TargetAcceptance / 2 && m_TargetAcceptance * m_Window >= 1) {
+                m_Temp = m_Temp / m_AdjustRate;
+            }
+
+            m_TargetAcceptance = m_TargetAcceptance * m_TargetDecay;
+            m_Worsening = 0;
+            m_WorseningAccepted = 0;
+        }
+
+        return m_LastImprovement < m_StagnationLimit;
+    }
+
+private:
+    double m_Temp;
+    double m_TargetAcceptance;
+    int m_Window;
+    int m_StagnationLimit;
+    double m_TargetDecay;
+    double m_AdjustRate;
+
+    int m_LastImprovement;
+    int m_Worsening;
+    int m_WorseningAccepted;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+// Geometric cooling, but on stagnation the temperature is raised back to reheatTemp instead of terminating.
+// Terminates after maxReheats reheats (maxReheats < 0 means never, the run ends only with a solution).
+class ReheatingSchedule : public GeometricSchedule {
+public:
+    ReheatingSchedule(double temp, double coolingRate, int stagnationLimit, double reheatTemp, int maxReheats = -1)
+            : GeometricSchedule(temp, coolingRate, stagnationLimit), m_ReheatTemp(reheatTemp), m_MaxReheats(maxReheats),
+              m_Reheats(0) {}
+
+    string name() const { return "reheating"; }
+    int reheats() const { return m_Reheats; }
+
+    bool update(int delta, bool accepted) {
+        if(GeometricSchedule::update(delta, accepted)) {
+            return true;
+        }
+
+        if(m_MaxReheats >= 0 && m_Reheats >= m_MaxReheats) {
+            return false;
+        }
+
+        m_Temp = m_ReheatTemp;
+        m_LastImprovement = 0;
+        m_Reheats++;
+
+        return true;
+    }
+
+private:
+    double m_ReheatTemp;
+    int m_MaxReheats;
+    int m_Reheats;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+// Fixed temperature set from outside, never terminates (replicas of parallel tempering)
+class ConstantSchedule {
+public:
+    ConstantSchedule(double temp) : m_Temp(temp) {}
+
+    double temperature() const { return m_Temp; }
+    string name() const { return "constant"; }
+    void setTemperature(double temp) { m_Temp = temp; }
+
+    bool update(int, bool) { return true; }
+
+private:
+    double m_Temp;
+};
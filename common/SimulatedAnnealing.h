@@ -0,0 +1,310 @@
+#pragma once
+
+#include <cmath>
+#include <random>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+#include <cstring>
+
+#include "CoolingSchedule.h"
+
+using namespace std;
+
+// Annealing loop shared by ChessBoard (HW02) and Sudoku (semestralWork).
+// Problem, schedule, random generator and observer are template parameters, so every call is resolved
+// at compile time and the loop is inlined into each problem.
+//
+// Problem policy:
+//   int  initialize()       - random start state, returns its score (lower is better)
+//   void proposeMove()      - pick a random neighbour move
+//   int  moveDelta()        - score change of the proposed move
+//   void applyMove()        - make the proposed move
+//   void revertMove()       - undo the applied move
+//   bool isSolved(int score)
+//   static constexpr bool SCORE_BEFORE_APPLY
+//                           - true:  moveDelta() scores the move before it is applied, rejected moves are never applied
+//                             false: the move is applied, scored and reverted when rejected
+//
+// Optional, only for checkpoints:
+//   void saveState(ostream & out) const
+//   bool loadState(istream & in)
+//
+// Schedule - see CoolingSchedule.h
+//
+// Observer:
+//   void onStart(int score)
+//   void onStep(unsigned long step, int score, double temp)
+//   void onFinish(unsigned long step, int score, double temp)
+
+//--------------------------------------------------------------------------------------------------------
+
+struct AnnealingResult {
+    unsigned long steps;
+    int score;
+    bool solved;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+struct NullObserver {
+    void onStart(int) {}
+    void onStep(unsigned long, int, double) {}
+    void onFinish(unsigned long, int, double) {}
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Problem, typename Schedule, typename Rng = mt19937, typename Observer = NullObserver>
+class SimulatedAnnealing {
+public:
+    SimulatedAnnealing(Problem & problem, Schedule schedule, Rng & rng, Observer observer = Observer())
+            : m_Problem(problem), m_Schedule(schedule), m_Rng(rng), m_Observer(observer) {}
+
+    // start() + advance() until solved or stopped by the schedule + finish()
+    AnnealingResult run();
+
+    // Stepwise interface for callers that drive the run themselves (parallel tempering).
+    // advance() makes at most maxSteps moves and returns false once the run is over.
+    void start();
+    bool advance(unsigned long maxSteps);
+    AnnealingResult finish();
+
+    // run() which writes the whole state (engine, schedule, generator, problem) to path every `every` steps.
+    // With resume the run continues from the checkpoint in path (when there is a valid one) exactly
+    // as if it was never interrupted.
+    AnnealingResult runCheckpointed(const string & path, unsigned long every, bool resume);
+
+    bool saveCheckpoint(const string & path) const;
+    bool loadCheckpoint(const string & path);
+
+    Schedule & schedule() { return m_Schedule; }
+    int score() const { return m_Score; }
+    bool solved() const { return m_Solved; }
+    unsigned long steps() const { return m_Step; }
+
+    static double computeProba(int delta, double t) {
+        return exp(-delta / t);
+    }
+
+private:
+    static constexpr char CHECKPOINT_MAGIC[4] = {'S', 'A', 'C', 'P'};
+    static constexpr uint32_t CHECKPOINT_VERSION = 1;
+
+    // Generator state as numbers of its textual form, stored in binary
+    using RngWord = conditional_t<(Rng::word_size > 32), uint64_t, uint32_t>;
+
+    bool accept(int delta);
+
+    Problem & m_Problem;
+    Schedule m_Schedule;
+    Rng & m_Rng;
+    Observer m_Observer;
+
+    int m_Score = 0;
+    unsigned long m_Step = 0;
+    bool m_Solved = false;
+};
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Problem, typename Schedule, typename Rng, typename Observer>
+inline bool SimulatedAnnealing<Problem, Schedule, Rng, Observer>::accept(int delta) {
+    if(delta <= 0) {
+        return true;
+    }
+
+    uniform_real_distribution<> distr(0.0, 1.0);
+
+    return computeProba(delta, m_Schedule.temperature()) >= distr(m_Rng);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Problem, typename Schedule, typename Rng, typename Observer>
+AnnealingResult SimulatedAnnealing<Problem, Schedule, Rng, Observer>::run() {
+    start();
+    advance(ULONG_MAX);
+
+    return finish();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Problem, typename Schedule, typename Rng, typename Observer>
+void SimulatedAnnealing<Problem, Schedule, Rng, Observer>::start() {
+    m_Score = m_Problem.initialize();
+    m_Step = 0;
+    m_Solved = m_Problem.isSolved(m_Score);
+
+    m_Observer.onStart(m_Score);
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Problem, typename Schedule, typename Rng, typename Observer>
+bool SimulatedAnnealing<Problem, Schedule, Rng, Observer>::advance(unsigned long maxSteps) {
+    for (unsigned long i = 0; i < maxSteps && !m_Solved; ++i) {
+        m_Problem.proposeMove();
+
+        int delta;
+        bool accepted;
+
+        if constexpr (Problem::SCORE_BEFORE_APPLY) {
+            delta = m_Problem.moveDelta();
+            accepted = accept(delta);
+            if(accepted) {
+                m_Problem.applyMove();
+            }
+        } else {
+            m_Problem.applyMove();
+            delta = m_Problem.moveDelta();
+            accepted = accept(delta);
+            if(!accepted) {
+                m_Problem.revertMove();
+            }
+        }
+
+        bool running = m_Schedule.update(delta, accepted);
+
+        if(accepted) {
+            m_Score += delta;
+            m_Solved = m_Problem.isSolved(m_Score);
+        }
+
+        m_Step++;
+        m_Observer.onStep(m_Step, m_Score, m_Schedule.temperature());
+
+        if(!running) {
+            return false;
+        }
+    }
+
+    return !m_Solved;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Problem, typename Schedule, typename Rng, typename Observer>
+AnnealingResult SimulatedAnnealing<Problem, Schedule, Rng, Observer>::finish() {
+    m_Observer.onFinish(m_Step, m_Score, m_Schedule.temperature());
+
+    return {m_Step, m_Score, m_Solved};
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Problem, typename Schedule, typename Rng, typename Observer>
+AnnealingResult SimulatedAnnealing<Problem, Schedule, Rng, Observer>::runCheckpointed(const string & path,
+                                                                                     unsigned long every,
+                                                                                     bool resume) {
+    if(!resume || !loadCheckpoint(path)) {
+        start();
+    }
+
+    while (advance(every)) {
+        saveCheckpoint(path);
+    }
+
+    return finish();
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+// Format: "SACP", version, sizeof(Schedule), step, score, solved, raw schedule, generator words, problem state.
+// Written to path.tmp and renamed, so an interrupted write never destroys the previous checkpoint
+template <typename Problem, typename Schedule, typename Rng, typename Observer>
+bool SimulatedAnnealing<Problem, Schedule, Rng, Observer>::saveCheckpoint(const string & path) const {
+    static_assert(is_trivially_copyable<Schedule>::value, "schedule state is stored byte by byte");
+
+    string tmpPath = path + ".tmp";
+    ofstream out(tmpPath, ios::out | ios::trunc | ios::binary);
+
+    uint32_t scheduleSize = sizeof(Schedule);
+    uint64_t step = m_Step;
+    int32_t score = m_Score;
+    uint8_t solved = m_Solved;
+
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.write(reinterpret_cast<const char *>(&CHECKPOINT_VERSION), sizeof(CHECKPOINT_VERSION));
+    out.write(reinterpret_cast<const char *>(&scheduleSize), sizeof(scheduleSize));
+    out.write(reinterpret_cast<const char *>(&step), sizeof(step));
+    out.write(reinterpret_cast<const char *>(&score), sizeof(score));
+    out.write(reinterpret_cast<const char *>(&solved), sizeof(solved));
+    out.write(reinterpret_cast<const char *>(&m_Schedule), sizeof(m_Schedule));
+
+    stringstream rngText;
+    rngText << m_Rng;
+    vector<RngWord> words;
+    RngWord word;
+    while (rngText >> word) {
+        words.push_back(word);
+    }
+
+    uint32_t wordCount = words.size();
+    out.write(reinterpret_cast<const char *>(&wordCount), sizeof(wordCount));
+    out.write(reinterpret_cast<const char *>(words.data()), wordCount * sizeof(RngWord));
+
+    m_Problem.saveState(out);
+
+    out.close();
+    if(!out) {
+        return false;
+    }
+
+    return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+//--------------------------------------------------------------------------------------------------------
+
+template <typename Problem, typename Schedule, typename Rng, typename Observer>
+bool SimulatedAnnealing<Problem, Schedule, Rng, Observer>::loadCheckpoint(const string & path) {
+    ifstream in(path, ios::in | ios::binary);
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    uint32_t version;
+    uint32_t scheduleSize;
+    uint64_t step;
+    int32_t score;
+    uint8_t solved;
+    Schedule schedule = m_Schedule;
+    uint32_t wordCount;
+
+    if(!in.read(magic, sizeof(magic)) || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0
+       || !in.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != CHECKPOINT_VERSION
+       || !in.read(reinterpret_cast<char *>(&scheduleSize), sizeof(scheduleSize)) || scheduleSize != sizeof(Schedule)
+       || !in.read(reinterpret_cast<char *>(&step), sizeof(step))
+       || !in.read(reinterpret_cast<char *>(&score), sizeof(score))
+       || !in.read(reinterpret_cast<char *>(&solved), sizeof(solved))
+       || !in.read(reinterpret_cast<char *>(&schedule), sizeof(schedule))
+       || !in.read(reinterpret_cast<char *>(&wordCount), sizeof(wordCount))) {
+        return false;
+    }
+
+    vector<RngWord> words(wordCount);
+    if(!in.read(reinterpret_cast<char *>(words.data()), wordCount * sizeof(RngWord))) {
+        return false;
+    }
+
+    stringstream rngText;
+    for (RngWord w : words) {
+        rngText << w << " ";
+    }
+    Rng rng;
+    if(!(rngText >> rng) || !m_Problem.loadState(in)) {
+        return false;
+    }
+
+    m_Step = step;
+    m_Score = score;
+    m_Solved = solved;
+    m_Schedule = schedule;
+    m_Rng = rng;
+
+    return true;
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <cmath>
+
+#include "Sudoku.h"
+#include "SudokuKernel.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+
+// Batch solving of puzzle files.
+// One puzzle per line, N*N characters row by row (N = 9, 16 or 25), '.' or '0' is an empty cell,
+// '1'-'9' are values 1-9 and 'A'... (or 'a'...) are values 10 and up. Empty lines and lines starting with '#' are skipped.
+// Puzzles are read in chunks, every chunk is solved on a WorkStealingPool and written out in input order.
+
+//-------------------------------------------------------------------------------------------------------------
+
+struct BatchOptions {
+    int threads = 1;
+
+    // Puzzle i is solved with seed + i, so results do not depend on which thread solved it
+    unsigned int seed = 0;
+
+    // Puzzles kept in memory at once
+    size_t chunkSize = 1024;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+struct PuzzleStats {
+    int gridSize;
+    bool solved;
+    unsigned long steps;
+    int score;
+    double ms;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+class BatchSolver {
+public:
+    BatchSolver(const BatchOptions & options);
+
+    // Writes one solution line per puzzle and a CSV line with stats per puzzle, returns number of puzzles
+    size_t run(istream & puzzles, ostream & solutions, ostream & stats);
+
+    static bool parsePuzzle(const string & line, vector<vector<int>> & grid);
+    static string formatGrid(const Sudoku & sudoku);
+
+private:
+    PuzzleStats solvePuzzle(const string & line, size_t index, int worker, string & solution);
+    Sudoku & workerSudoku(int worker, int gridSize);
+
+    BatchOptions m_Options;
+    WorkStealingPool m_Pool;
+
+    // Sudoku instances owned by each worker, one per grid size, reused between puzzles
+    vector<vector<unique_ptr<Sudoku>>> m_WorkerSudokus;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline BatchSolver::BatchSolver(const BatchOptions & options)
+        : m_Options(options), m_Pool(options.threads), m_WorkerSudokus(m_Pool.getWorkers()) {}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool BatchSolver::parsePuzzle(const string & line, vector<vector<int>> & grid) {
+    int gridSize = (int) round(sqrt(line.size()));
+    int blockSize = (int) round(sqrt(gridSize));
+
+    if(gridSize * gridSize != (int) line.size() || blockSize * blockSize != gridSize || gridSize > Sudoku::MAX_SIZE) {
+        return false;
+    }
+
+    grid.assign(gridSize, vector<int>(gridSize, 0));
+
+    for (int i = 0; i < (int) line.size(); ++i) {
+        char c = line[i];
+        int value;
+
+        if(c == '.' || c == '0') {
+            value = 0;
+        } else if(c >= '1' && c <= '9') {
+            value = c - '0';
+        } else if(c >= 'A' && c <= 'Z') {
+            value = c - 'A' + 10;
+        } else if(c >= 'a' && c <= 'z') {
+            value = c - 'a' + 10;
+        } else {
+            return false;
+        }
+
+        if(value > gridSize) {
+            return false;
+        }
+        grid[i / gridSize][i % gridSize] = value;
+    }
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline string BatchSolver::formatGrid(const Sudoku & sudoku) {
+    int gridSize = sudoku.getGridSize();
+    string line;
+    line.reserve(gridSize * gridSize);
+
+    for (int row = 0; row < gridSize; ++row) {
+        for (int col = 0; col < gridSize; ++col) {
+            int value = sudoku.cell(row, col);
+            line += value == 0 ? '.' : (value < 10 ? (char) ('0' + value) : (char) ('A' + value - 10));
+        }
+    }
+
+    return line;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline Sudoku & BatchSolver::workerSudoku(int worker, int gridSize) {
+    auto & sudokus = m_WorkerSudokus[worker];
+    if(sudokus.size() <= (size_t) gridSize) {
+        sudokus.resize(gridSize + 1);
+    }
+
+    if(!sudokus[gridSize]) {
+        sudokus[gridSize] = make_unique<Sudoku>(gridSize, m_Options.seed);
+        sudokus[gridSize]->setPrintMode(false, false);
+    }
+
+    return *sudokus[gridSize];
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline PuzzleStats BatchSolver::solvePuzzle(const string & line, size_t index, int worker, string & solution) {
+    vector<vector<int>> grid;
+
+    if(!parsePuzzle(line, grid)) {
+        solution = line;
+        return {0, false, 0, 0, 0};
+    }
+
+    Sudoku & sudoku = workerSudoku(worker, grid.size());
+    sudoku.setSeed(m_Options.seed + index);
+    sudoku.setInitialValues(grid);
+
+    auto start = chrono::steady_clock::now();
+    AnnealingResult result = annealFixedSize(sudoku, ReheatingSchedule(0.5, 0.99999, 5000, 0.5, 20));
+    auto end = chrono::steady_clock::now();
+
+    solution = formatGrid(sudoku);
+
+    return {(int) grid.size(), result.solved, result.steps, result.score,
+            chrono::duration<double, milli>(end - start).count()};
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline size_t BatchSolver::run(istream & puzzles, ostream & solutions, ostream & stats) {
+    vector<string> lines;
+    vector<string> chunkSolutions;
+    vector<PuzzleStats> chunkStats;
+    size_t total = 0;
+    size_t solved = 0;
+    bool moreInput = true;
+
+    stats << "puzzle,size,solved,steps,score,ms\n";
+
+    auto start = chrono::steady_clock::now();
+
+    while (moreInput) {
+        lines.clear();
+        string line;
+
+        while (lines.size() < m_Options.chunkSize) {
+            if(!getline(puzzles, line)) {
+                moreInput = false;
+                break;
+            }
+            if(!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if(line.empty() || line[0] == '#') {
+                continue;
+            }
+            lines.push_back(line);
+        }
+
+        chunkSolutions.assign(lines.size(), "");
+        chunkStats.assign(lines.size(), {});
+
+        m_Pool.run(lines.size(), [&](size_t i, int worker) {
+            chunkStats[i] = solvePuzzle(lines[i], total + i, worker, chunkSolutions[i]);
+        });
+
+        for (size_t i = 0; i < lines.size(); ++i) {
+            const PuzzleStats & s = chunkStats[i];
+            solutions << chunkSolutions[i] << "\n";
+            stats << total + i << "," << s.gridSize << "," << s.solved << "," << s.steps << "," << s.score << ","
+                  << s.ms << "\n";
+            solved += s.solved;
+        }
+
+        total += lines.size();
+    }
+
+    auto end = chrono::steady_clock::now();
+    double seconds = chrono::duration<double>(end - start).count();
+
+    cout << "Puzzles: " << total << ", solved: " << solved << ", threads: " << m_Pool.getWorkers() << endl;
+    cout << "Time: " << seconds << " s, throughput: " << (seconds > 0 ? total / seconds : 0) << " puzzles/s" << endl;
+
+    return total;
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+using namespace std;
+
+// Knuth's Algorithm X with dancing links for Sudoku.
+// All nodes live in one array and are linked by indices (node 0 = root, 1..columns = column headers),
+// so covering and uncovering only touch ints in contiguous vectors.
+// Sudoku of size N is an exact cover problem with 4*N*N columns (cell filled, value in row, value in column,
+// value in block) and one row per (cell, value) candidate, every row has exactly 4 nodes.
+
+//-------------------------------------------------------------------------------------------------------------
+
+class ExactCover {
+public:
+    // grid[row * gridSize + col], 0 = empty cell
+    ExactCover(int gridSize, const vector<uint8_t> & grid);
+
+    // Searches for one solution, gives up after budgetMs milliseconds (budgetMs < 0 = no limit).
+    // On success writes the solution to grid.
+    bool solve(vector<uint8_t> & grid, double budgetMs);
+
+    bool timedOut() const { return m_TimedOut; }
+
+    // Number of search nodes visited
+    unsigned long updates() const { return m_Updates; }
+
+private:
+    static const int CHECK_EVERY = 1024;
+
+    int addColumn();
+    void addRow(int row, int col, int value);
+    void cover(int column);
+    void uncover(int column);
+    bool search();
+
+    int m_GridSize;
+    int m_BlockSize;
+    bool m_Consistent;
+
+    vector<int> m_Left;
+    vector<int> m_Right;
+    vector<int> m_Up;
+    vector<int> m_Down;
+    vector<int> m_Column;
+
+    // Candidate (row * N + col) * N + value - 1 of every node, column size of every header
+    vector<int> m_Candidate;
+    vector<int> m_Size;
+
+    vector<int> m_Solution;
+
+    chrono::steady_clock::time_point m_Deadline;
+    bool m_HasDeadline;
+    bool m_TimedOut;
+    unsigned long m_Updates;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline ExactCover::ExactCover(int gridSize, const vector<uint8_t> & grid)
+        : m_GridSize(gridSize), m_BlockSize(1), m_Consistent(true), m_HasDeadline(false), m_TimedOut(false),
+          m_Updates(0) {
+    while (m_BlockSize * m_BlockSize < gridSize) {
+        m_BlockSize++;
+    }
+
+    int N = gridSize;
+    int columns = 4 * N * N;
+    int nodes = 1 + columns + 4 * N * N * N;
+
+    m_Left.reserve(nodes);
+    m_Right.reserve(nodes);
+    m_Up.reserve(nodes);
+    m_Down.reserve(nodes);
+    m_Column.reserve(nodes);
+    m_Candidate.reserve(nodes);
+
+    // Root
+    addColumn();
+    for (int i = 0; i < columns; ++i) {
+        addColumn();
+    }
+    m_Size.assign(columns + 1, 0);
+
+    // Values already used by the clues in every row, column and block
+    vector<uint64_t> rowUsed(N, 0), colUsed(N, 0), blockUsed(N, 0);
+    for (int row = 0; row < N; ++row) {
+        for (int col = 0; col < N; ++col) {
+            int value = grid[row * N + col];
+            if(value != 0) {
+                rowUsed[row] |= 1ULL << (value - 1);
+                colUsed[col] |= 1ULL << (value - 1);
+                blockUsed[(row / m_BlockSize) * m_BlockSize + col / m_BlockSize] |= 1ULL << (value - 1);
+            }
+        }
+    }
+
+    vector<int> clueRows;
+
+    for (int row = 0; row < N; ++row) {
+        for (int col = 0; col < N; ++col) {
+            int value = grid[row * N + col];
+
+            if(value != 0) {
+                clueRows.push_back(m_Column.size());
+                addRow(row, col, value);
+                continue;
+            }
+
+            int block = (row / m_BlockSize) * m_BlockSize + col / m_BlockSize;
+            uint64_t used = rowUsed[row] | colUsed[col] | blockUsed[block];
+            for (int v = 1; v <= N; ++v) {
+                if(!((used >> (v - 1)) & 1)) {
+                    addRow(row, col, v);
+                }
+            }
+        }
+    }
+
+    // Clues are selected up front, two clues on the same column mean the puzzle has no solution
+    for (int first : clueRows) {
+        int node = first;
+        do {
+            if(m_Right[m_Left[m_Column[node]]] != m_Column[node]) {
+                m_Consistent = false;
+                return;
+            }
+            cover(m_Column[node]);
+            node = m_Right[node];
+        } while (node != first);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline int ExactCover::addColumn() {
+    int index = m_Column.size();
+
+    m_Left.push_back(index - 1);
+    m_Right.push_back(0);
+    m_Up.push_back(index);
+    m_Down.push_back(index);
+    m_Column.push_back(index);
+    m_Candidate.push_back(-1);
+
+    // Close the header ring
+    if(index > 0) {
+        m_Right[index - 1] = index;
+        m_Left[0] = index;
+    }
+
+    return index;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void ExactCover::addRow(int row, int col, int value) {
+    int N = m_GridSize;
+    int v = value - 1;
+    int block = (row / m_BlockSize) * m_BlockSize + col / m_BlockSize;
+    int columns[4] = {1 + row * N + col, 1 + N * N + row * N + v, 1 + 2 * N * N + col * N + v,
+                      1 + 3 * N * N + block * N + v};
+    int first = m_Column.size();
+
+    for (int i = 0; i < 4; ++i) {
+        int node = first + i;
+        int column = columns[i];
+
+        m_Left.push_back(i == 0 ? first + 3 : node - 1);
+        m_Right.push_back(i == 3 ? first : node + 1);
+        m_Up.push_back(m_Up[column]);
+        m_Down.push_back(column);
+        m_Column.push_back(column);
+        m_Candidate.push_back((row * N + col) * N + v);
+
+        m_Down[m_Up[column]] = node;
+        m_Up[column] = node;
+        m_Size[column]++;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void ExactCover::cover(int column) {
+    m_Right[m_Left[column]] = m_Right[column];
+    m_Left[m_Right[column]] = m_Left[column];
+
+    for (int i = m_Down[column]; i != column; i = m_Down[i]) {
+        for (int j = m_Right[i]; j != i; j = m_Right[j]) {
+            m_Down[m_Up[j]] = m_Down[j];
+            m_Up[m_Down[j]] = m_Up[j];
+            m_Size[m_Column[j]]--;
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void ExactCover::uncover(int column) {
+    for (int i = m_Up[column]; i != column; i = m_Up[i]) {
+        for (int j = m_Left[i]; j != i; j = m_Left[j]) {
+            m_Size[m_Column[j]]++;
+            m_Down[m_Up[j]] = j;
+            m_Up[m_Down[j]] = j;
+        }
+    }
+
+    m_Right[m_Left[column]] = column;
+    m_Left[m_Right[column]] = column;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool ExactCover::search() {
+    if(m_Right[0] == 0) {
+        return true;
+    }
+
+    if(++m_Updates % CHECK_EVERY == 0 && m_HasDeadline && chrono::steady_clock::now() > m_Deadline) {
+        m_TimedOut = true;
+    }
+    if(m_TimedOut) {
+        return false;
+    }
+
+    // Column with the fewest rows left
+    int column = m_Right[0];
+    for (int c = m_Right[column]; c != 0; c = m_Right[c]) {
+        if(m_Size[c] < m_Size[column]) {
+            column = c;
+        }
+    }
+
+    if(m_Size[column] == 0) {
+        return false;
+    }
+
+    cover(column);
+
+    for (int row = m_Down[column]; row != column; row = m_Down[row]) {
+        m_Solution.push_back(row);
+        for (int j = m_Right[row]; j != row; j = m_Right[j]) {
+            cover(m_Column[j]);
+        }
+
+        if(search()) {
+            return true;
+        }
+
+        for (int j = m_Left[row]; j != row; j = m_Left[j]) {
+            uncover(m_Column[j]);
+        }
+        m_Solution.pop_back();
+
+        if(m_TimedOut) {
+            break;
+        }
+    }
+
+    uncover(column);
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool ExactCover::solve(vector<uint8_t> & grid, double budgetMs) {
+    if(!m_Consistent) {
+        return false;
+    }
+
+    m_HasDeadline = budgetMs >= 0;
+    m_Deadline = chrono::steady_clock::now() + chrono::microseconds((long long) (budgetMs * 1000));
+    m_TimedOut = false;
+    m_Updates = 0;
+    m_Solution.clear();
+
+    if(!search()) {
+        return false;
+    }
+
+    for (int node : m_Solution) {
+        int candidate = m_Candidate[node];
+        grid[candidate / m_GridSize] = candidate % m_GridSize + 1;
+    }
+
+    return true;
+}
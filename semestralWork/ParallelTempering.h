@@ -0,0 +1,266 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "Sudoku.h"
+
+using namespace std;
+
+// Replica exchange for Sudoku.
+// Every replica is its own Sudoku annealed at a fixed temperature from a geometric ladder, one thread per replica.
+// After every sweep of sweepSteps moves, neighbouring temperatures (pairs 0-1, 2-3, ... and 1-2, 3-4, ... in
+// alternating rounds) try to exchange their replicas with probability min(1, exp((E_i - E_j)(1/T_i - 1/T_j))).
+// Replicas swap temperatures, not grids. Lower replica of every pair decides and publishes the new
+// assignment through atomics, threads only meet at a spinning barrier, no mutexes are involved.
+
+//-------------------------------------------------------------------------------------------------------------
+
+struct TemperingOptions {
+    int replicas = 4;
+    double minTemp = 0.1;
+    double maxTemp = 0.5;
+    unsigned long sweepSteps = 500;
+
+    // Upper bound of sweeps, the run stops earlier when any replica is solved
+    unsigned long maxRounds = 2000;
+    unsigned int seed = 0;
+
+    // Off for benchmarks, singles propagation alone solves the built-in puzzles
+    bool propagation = false;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+struct TemperingResult {
+    bool solved;
+    int bestScore;
+    unsigned long rounds;
+    unsigned long totalSteps;
+    double ms;
+
+    // Accepted / attempted exchanges between temperature i and i + 1
+    vector<double> swapAcceptance;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Sense-reversing barrier, waiting threads spin (with yield, replicas may outnumber cores)
+class SpinBarrier {
+public:
+    SpinBarrier(int threads) : m_Threads(threads), m_Waiting(0), m_Generation(0) {}
+
+    void wait() {
+        unsigned int generation = m_Generation.load(memory_order_acquire);
+
+        if(m_Waiting.fetch_add(1, memory_order_acq_rel) + 1 == m_Threads) {
+            m_Waiting.store(0, memory_order_relaxed);
+            m_Generation.fetch_add(1, memory_order_acq_rel);
+            return;
+        }
+
+        while (m_Generation.load(memory_order_acquire) == generation) {
+            this_thread::yield();
+        }
+    }
+
+private:
+    int m_Threads;
+    atomic<int> m_Waiting;
+    atomic<unsigned int> m_Generation;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+class ParallelTempering {
+public:
+    ParallelTempering(const vector<vector<int>> & puzzle, const TemperingOptions & options);
+
+    TemperingResult run();
+
+    // Grid of the replica with the best final score
+    const Sudoku & bestReplica() const { return *m_Replicas[m_BestReplica]; }
+
+    const vector<double> & temperatures() const { return m_Temperatures; }
+
+private:
+    void replicaLoop(int replica);
+    // temp = temperature of the replica before the exchange phase of this round
+    void exchange(int replica, int temp, unsigned long round);
+
+    TemperingOptions m_Options;
+    vector<unique_ptr<Sudoku>> m_Replicas;
+    vector<double> m_Temperatures;
+
+    // Which temperature each replica has and which replica is at each temperature
+    unique_ptr<atomic<int>[]> m_TempOfReplica;
+    unique_ptr<atomic<int>[]> m_ReplicaAtTemp;
+
+    // Scores published before every exchange
+    unique_ptr<atomic<int>[]> m_Energy;
+
+    // Only the deciding (lower) replica of a pair writes these, counted per temperature pair
+    unique_ptr<atomic<unsigned long>[]> m_SwapAttempts;
+    unique_ptr<atomic<unsigned long>[]> m_SwapAccepted;
+
+    // One generator per replica for exchange decisions, the Sudoku has its own for moves
+    vector<mt19937> m_ExchangeGens;
+
+    SpinBarrier m_Barrier;
+    atomic<bool> m_Solved;
+    atomic<unsigned long> m_TotalSteps;
+    unsigned long m_Rounds;
+    int m_BestReplica;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline ParallelTempering::ParallelTempering(const vector<vector<int>> & puzzle, const TemperingOptions & options)
+        : m_Options(options), m_Barrier(max(options.replicas, 2)), m_Solved(false), m_TotalSteps(0), m_Rounds(0),
+          m_BestReplica(0) {
+    m_Options.replicas = max(options.replicas, 2);
+    int replicas = m_Options.replicas;
+
+    m_TempOfReplica = make_unique<atomic<int>[]>(replicas);
+    m_ReplicaAtTemp = make_unique<atomic<int>[]>(replicas);
+    m_Energy = make_unique<atomic<int>[]>(replicas);
+    m_SwapAttempts = make_unique<atomic<unsigned long>[]>(replicas - 1);
+    m_SwapAccepted = make_unique<atomic<unsigned long>[]>(replicas - 1);
+
+    for (int i = 0; i < replicas; ++i) {
+        // Geometric ladder minTemp .. maxTemp
+        m_Temperatures.push_back(m_Options.minTemp * pow(m_Options.maxTemp / m_Options.minTemp, (double) i / (replicas - 1)));
+
+        m_Replicas.push_back(make_unique<Sudoku>((int) puzzle.size(), m_Options.seed * replicas + i));
+        m_Replicas.back()->setPrintMode(false, false);
+        m_Replicas.back()->setPropagation(m_Options.propagation);
+        m_Replicas.back()->setInitialValues(puzzle);
+
+        m_ExchangeGens.emplace_back(m_Options.seed * replicas + i + 0x9e3779b9u);
+
+        m_TempOfReplica[i] = i;
+        m_ReplicaAtTemp[i] = i;
+        m_Energy[i] = 0;
+    }
+
+    for (int i = 0; i + 1 < replicas; ++i) {
+        m_SwapAttempts[i] = 0;
+        m_SwapAccepted[i] = 0;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline TemperingResult ParallelTempering::run() {
+    auto start = chrono::steady_clock::now();
+
+    vector<thread> threads;
+    for (int replica = 1; replica < m_Options.replicas; ++replica) {
+        threads.emplace_back(&ParallelTempering::replicaLoop, this, replica);
+    }
+    replicaLoop(0);
+
+    for (auto & t : threads) {
+        t.join();
+    }
+
+    auto end = chrono::steady_clock::now();
+
+    TemperingResult result;
+    result.solved = m_Solved;
+    result.rounds = m_Rounds;
+    result.totalSteps = m_TotalSteps;
+    result.ms = chrono::duration<double, milli>(end - start).count();
+
+    m_BestReplica = 0;
+    for (int i = 1; i < m_Options.replicas; ++i) {
+        if(m_Energy[i] < m_Energy[m_BestReplica]) {
+            m_BestReplica = i;
+        }
+    }
+    result.bestScore = m_Energy[m_BestReplica];
+
+    for (int i = 0; i + 1 < m_Options.replicas; ++i) {
+        result.swapAcceptance.push_back(m_SwapAttempts[i] ? (double) m_SwapAccepted[i] / m_SwapAttempts[i] : 0);
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void ParallelTempering::replicaLoop(int replica) {
+    Sudoku & sudoku = *m_Replicas[replica];
+    auto annealer = sudoku.annealer(ConstantSchedule(m_Temperatures[m_TempOfReplica[replica]]), NullObserver());
+
+    annealer.start();
+
+    for (unsigned long round = 0; ; ++round) {
+        // Assignment is only changed between the two barriers, read it once before the first one. The lower
+        // replica of a pair may swap before its partner looks, so the partner must not read it again.
+        int temp = m_TempOfReplica[replica].load(memory_order_acquire);
+        annealer.schedule().setTemperature(m_Temperatures[temp]);
+        annealer.advance(m_Options.sweepSteps);
+
+        if(annealer.solved()) {
+            m_Solved.store(true, memory_order_release);
+        }
+        m_Energy[replica].store(annealer.score(), memory_order_release);
+
+        // All energies and the solved flag are published
+        m_Barrier.wait();
+
+        bool stop = m_Solved.load(memory_order_acquire) || round + 1 >= m_Options.maxRounds;
+
+        if(!stop) {
+            exchange(replica, temp, round);
+        }
+
+        // New temperature assignment is published (or everybody agreed to stop)
+        m_Barrier.wait();
+
+        if(stop) {
+            if(replica == 0) {
+                m_Rounds = round + 1;
+            }
+            break;
+        }
+    }
+
+    m_TotalSteps += annealer.steps();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void ParallelTempering::exchange(int replica, int temp, unsigned long round) {
+    // This replica decides only when it is the lower temperature of a pair in this round
+    if(temp % 2 != (int) (round % 2) || temp + 1 >= m_Options.replicas) {
+        return;
+    }
+
+    int partner = m_ReplicaAtTemp[temp + 1].load(memory_order_acquire);
+    double beta1 = 1.0 / m_Temperatures[temp];
+    double beta2 = 1.0 / m_Temperatures[temp + 1];
+    int energy1 = m_Energy[replica].load(memory_order_acquire);
+    int energy2 = m_Energy[partner].load(memory_order_acquire);
+
+    double exponent = (energy1 - energy2) * (beta1 - beta2);
+    uniform_real_distribution<> distr(0.0, 1.0);
+
+    m_SwapAttempts[temp].fetch_add(1, memory_order_relaxed);
+
+    if(exponent >= 0 || exp(exponent) >= distr(m_ExchangeGens[replica])) {
+        m_TempOfReplica[replica].store(temp + 1, memory_order_release);
+        m_TempOfReplica[partner].store(temp, memory_order_release);
+        m_ReplicaAtTemp[temp].store(partner, memory_order_release);
+        m_ReplicaAtTemp[temp + 1].store(replica, memory_order_release);
+
+        m_SwapAccepted[temp].fetch_add(1, memory_order_relaxed);
+    }
+}
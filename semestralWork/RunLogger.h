@@ -0,0 +1,256 @@
+#pragma once
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <climits>
+
+using namespace std;
+
+// Run log of the annealer (score and temperature over steps).
+// Steps are sampled (every k steps and/or whenever the best score of the run improves), samples go to
+// a fixed-size single-producer/single-consumer ring buffer and a background thread writes them to disk,
+// so memory does not grow with the step count and the annealing thread never waits for I/O.
+// When the buffer is full the annealing thread yields until the writer catches up, no sample is lost.
+//
+// CSV:    run,iteration,score,temperature
+// Binary: "SALG", uint32 version, then IterationData records of 24 bytes (native byte order),
+//         exportCsv() converts it to the CSV above.
+
+//-------------------------------------------------------------------------------------------------------------
+
+struct IterationData {
+    uint32_t run;
+    int32_t conflicts;
+    double temperature;
+    uint64_t step;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+struct LogOptions {
+    // Sample every k-th step, 0 = no periodic samples
+    unsigned long every = 1000;
+
+    // Sample every step which improves the best score of the run
+    bool onImprovement = true;
+
+    // Ring buffer capacity in samples, rounded up to a power of two
+    size_t capacity = 4096;
+
+    bool binary = false;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+class RunLogger {
+public:
+    RunLogger(const string & path, const LogOptions & options = LogOptions());
+    ~RunLogger();
+
+    RunLogger(const RunLogger &) = delete;
+    RunLogger & operator=(const RunLogger &) = delete;
+
+    bool isOpen() const { return m_Open; }
+
+    // Starts a new run, samples are tagged with runNr
+    void beginRun(int runNr);
+
+    void log(unsigned long step, int score, double temp) {
+        bool improved = score < m_Best;
+        if(improved) {
+            m_Best = score;
+        }
+
+        if((m_Options.every && step % m_Options.every == 0) || (m_Options.onImprovement && improved)) {
+            push({m_Run, score, temp, step});
+        }
+    }
+
+    // Last state of the run is always logged
+    void endRun(unsigned long step, int score, double temp);
+
+    // Waits for the writer to drain the buffer and closes the file
+    void close();
+
+    static bool exportCsv(const string & binaryPath, const string & csvPath);
+
+private:
+    static constexpr char MAGIC[4] = {'S', 'A', 'L', 'G'};
+    static constexpr uint32_t VERSION = 1;
+
+    void push(const IterationData & data);
+    void writerLoop();
+    void write(const IterationData & data);
+
+    LogOptions m_Options;
+    ofstream m_Out;
+    bool m_Open;
+
+    uint32_t m_Run;
+    int m_Best;
+    unsigned long m_LastStep;
+
+    vector<IterationData> m_Buffer;
+    size_t m_Mask;
+
+    // m_Head - next sample for the writer, m_Tail - next free slot for the annealer
+    atomic<size_t> m_Head;
+    atomic<size_t> m_Tail;
+    atomic<bool> m_Stop;
+    thread m_Writer;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline RunLogger::RunLogger(const string & path, const LogOptions & options)
+        : m_Options(options), m_Run(0), m_Best(INT32_MAX), m_LastStep(ULONG_MAX), m_Head(0), m_Tail(0),
+          m_Stop(false) {
+    size_t capacity = 1;
+    while (capacity < options.capacity) {
+        capacity <<= 1;
+    }
+    m_Buffer.resize(capacity);
+    m_Mask = capacity - 1;
+
+    m_Out.open(path, options.binary ? ios::out | ios::trunc | ios::binary : ios::out | ios::trunc);
+    m_Open = (bool) m_Out;
+
+    if(!m_Open) {
+        return;
+    }
+
+    if(options.binary) {
+        m_Out.write(MAGIC, sizeof(MAGIC));
+        m_Out.write(reinterpret_cast<const char *>(&VERSION), sizeof(VERSION));
+    } else {
+        m_Out << "run,iteration,score,temperature\n";
+    }
+
+    m_Writer = thread(&RunLogger::writerLoop, this);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline RunLogger::~RunLogger() {
+    close();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void RunLogger::beginRun(int runNr) {
+    m_Run = runNr;
+    m_Best = INT32_MAX;
+    m_LastStep = ULONG_MAX;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void RunLogger::endRun(unsigned long step, int score, double temp) {
+    push({m_Run, score, temp, step});
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void RunLogger::push(const IterationData & data) {
+    if(!m_Open) {
+        return;
+    }
+
+    // Improvement and periodic sample of the same step
+    if(data.step == m_LastStep) {
+        return;
+    }
+    m_LastStep = data.step;
+
+    size_t tail = m_Tail.load(memory_order_relaxed);
+
+    while (tail - m_Head.load(memory_order_acquire) > m_Mask) {
+        this_thread::yield();
+    }
+
+    m_Buffer[tail & m_Mask] = data;
+    m_Tail.store(tail + 1, memory_order_release);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void RunLogger::writerLoop() {
+    while (true) {
+        // Stop is read before the tail, so samples pushed before close() are always drained
+        bool stop = m_Stop.load(memory_order_acquire);
+        size_t head = m_Head.load(memory_order_relaxed);
+        size_t tail = m_Tail.load(memory_order_acquire);
+
+        if(head == tail) {
+            if(stop) {
+                break;
+            }
+            this_thread::sleep_for(chrono::milliseconds(1));
+            continue;
+        }
+
+        for (; head != tail; ++head) {
+            write(m_Buffer[head & m_Mask]);
+        }
+        m_Head.store(head, memory_order_release);
+    }
+
+    m_Out.flush();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void RunLogger::write(const IterationData & data) {
+    if(m_Options.binary) {
+        m_Out.write(reinterpret_cast<const char *>(&data), sizeof(data));
+    } else {
+        m_Out << data.run << "," << data.step << "," << data.conflicts << "," << data.temperature << "\n";
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void RunLogger::close() {
+    if(!m_Open) {
+        return;
+    }
+
+    m_Stop.store(true, memory_order_release);
+    m_Writer.join();
+    m_Out.close();
+    m_Open = false;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool RunLogger::exportCsv(const string & binaryPath, const string & csvPath) {
+    ifstream in(binaryPath, ios::in | ios::binary);
+    char magic[sizeof(MAGIC)];
+    uint32_t version;
+
+    if(!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+       || !in.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != VERSION) {
+        return false;
+    }
+
+    ofstream out(csvPath, ios::out | ios::trunc);
+    if(!out) {
+        return false;
+    }
+
+    out << "run,iteration,score,temperature\n";
+
+    IterationData data;
+    while (in.read(reinterpret_cast<char *>(&data), sizeof(data))) {
+        out << data.run << "," << data.step << "," << data.conflicts << "," << data.temperature << "\n";
+    }
+
+    return true;
+}
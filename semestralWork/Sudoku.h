@@ -0,0 +1,944 @@
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <fstream>
+#include <algorithm>
+
+#include "../common/CoolingSchedule.h"
+#include "../common/SimulatedAnnealing.h"
+#include "RunLogger.h"
+#include "ExactCover.h"
+
+using namespace std;
+
+//-------------------------------------------------------------------------------------------------------------
+
+struct Coord {
+    int m_Row;
+    int m_Col;
+
+    Coord(int row, int col) {
+     m_Row = row;
+     m_Col = col;
+    }
+
+    Coord() : m_Row(0), m_Col(0) {};
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Jednotky, ve kterých operátor prohazuje (bloky, řádky, úseky řádků a sloupců v bloku), a jejich volné buňky.
+// Počítá se jednou po zadání, výběr tahu je pak O(1) a bez alokace
+struct MoveTable {
+    // Indexy volných buněk (row * N + col), jednotka po jednotce
+    vector<uint16_t> m_Cells;
+
+    // Jednotka u má buňky m_Cells[m_Start[u]] .. m_Cells[m_Start[u + 1] - 1]
+    vector<uint32_t> m_Start;
+
+    // Jednotky s aspoň dvěma volnými buňkami, jen v nich má prohození smysl
+    vector<uint16_t> m_Movable;
+
+    void clear() {
+        m_Cells.clear();
+        m_Start.assign(1, 0);
+        m_Movable.clear();
+    }
+
+    void closeUnit() {
+        if(m_Cells.size() - m_Start.back() > 1) {
+            m_Movable.push_back(m_Start.size() - 1);
+        }
+        m_Start.push_back(m_Cells.size());
+    }
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+enum class MoveOperator {
+    SUB_GRID,
+    ROW,
+    SUB_GRID_ROW_COL
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+struct MoveStats {
+    unsigned long proposed;
+    unsigned long accepted;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------------------
+
+class Sudoku {
+public:
+    // Bez seedu se seed vezme z hodin, getSeed() ho vrátí, aby šel běh zopakovat
+    Sudoku(int gridSize);
+    Sudoku(int gridSize, unsigned int seed);
+
+    // Nastaví zadání, a pokud je zapnutá propagace, rovnou zafixuje i všechny vynucené buňky
+    void setInitialValues(const vector<vector<int>> & initialValues);
+
+    // Propagace omezení před fillGrid (výchozí zapnuto)
+    void setPropagation(bool propagation) { m_Propagation = propagation; }
+
+    // Naked a hidden singles nad maskami kandidátů, dokud se něco mění.
+    // Vynucené buňky zapíše a označí jako zadané, vrací jejich počet.
+    // Při sporu (buňka bez kandidátů, hodnota bez místa v jednotce) skončí a nechá zbytek na žíhání.
+    int propagate();
+
+    // Dekadický logaritmus počtu stavů, které žíhání prohledává = součin (volné buňky v bloku)! přes bloky
+    double searchSpaceLog10() const;
+
+    // printResult - print start score and final grid when not animating (benchmarks turn both off)
+    void setPrintMode(bool printMode, bool printResult = true) { PRINT_MODE = printMode; PRINT_RESULT = printResult; }
+
+    // Default schedule: start at 0.5, geometric cooling 0.99999, stop after 5000 steps without improvement
+    AnnealingResult simulatedAnnealing();
+
+    template <typename Schedule>
+    AnnealingResult simulatedAnnealing(Schedule schedule);
+
+    // Same run with a custom observer, e.g. NullObserver for batch runs without printing and run log
+    template <typename Schedule, typename Observer>
+    AnnealingResult simulatedAnnealing(Schedule schedule, Observer observer);
+
+    // Přesné řešení (DLX) ze zadaných buněk, po budgetMs milisekundách to vzdá (budgetMs < 0 = bez limitu).
+    // Při úspěchu zapíše celé řešení do mřížky
+    bool solveExact(double budgetMs);
+
+    // Nejdřív přesný řešič, žíhání jen když nestihne rozpočet.
+    // Výsledek přesného řešení má steps = 0
+    template <typename Schedule>
+    AnnealingResult solveHybrid(double budgetMs, Schedule schedule);
+
+    // Žíhání s checkpointem do path každých every kroků, s resume pokračuje z checkpointu přesně tam, kde skončilo
+    template <typename Schedule>
+    AnnealingResult simulatedAnnealing(Schedule schedule, const string & checkpointPath, unsigned long every,
+                                       bool resume);
+
+    // Annealing engine bound to this grid and its generator, for callers that drive the run stepwise
+    template <typename Schedule, typename Observer>
+    SimulatedAnnealing<Sudoku, Schedule, mt19937, Observer> annealer(Schedule schedule, Observer observer);
+
+    // Operátor pro další běhy (výchozí SUB_GRID)
+    void setMoveOperator(MoveOperator moveOperator) { m_Operator = moveOperator; }
+    MoveOperator getMoveOperator() const { return m_Operator; }
+
+    // Navržené a přijaté tahy posledního běhu
+    MoveStats moveStats() const { return m_Stats; }
+
+    void setSeed(unsigned int seed) { m_Seed = seed; m_Gen.seed(seed); }
+    unsigned int getSeed() const { return m_Seed; }
+    int getGridSize() const { return m_GridSize; }
+
+    // Problem policy for SimulatedAnnealing - swap is scored from the count tables before it is applied
+    static constexpr bool SCORE_BEFORE_APPLY = true;
+    int initialize();
+    void proposeMove();
+    int moveDelta() const;
+    void applyMove();
+    void revertMove();
+    bool isSolved(int score) const;
+
+    // Stav mřížky pro checkpoint: velikost, operátor, buňky a zadané buňky
+    void saveState(ostream & out) const;
+    bool loadState(istream & in);
+
+    // Observer for SimulatedAnnealing - animation, run log and final grid
+    struct Printer {
+        Sudoku & m_Sudoku;
+
+        void onStart(int score);
+        void onStep(unsigned long step, int score, double temp);
+        void onFinish(unsigned long step, int score, double temp);
+    };
+
+    void fillGrid();
+    void print(unsigned long step, int conflicts, double temp);
+    void logData(unsigned long step, int conflicts, double temp);
+
+    // Průběh dalších běhů s Printerem se zapisuje do loggeru pod číslem runNr, nullptr = bez logu
+    void setLogger(RunLogger * logger, int runNr) { m_Logger = logger; m_RunNr = runNr; }
+
+    // Největší podporovaná velikost - hodnoty v řádku/sloupci/bloku se vejdou do 64bitové masky
+    static const int MAX_SIZE = 64;
+
+    // Funkce pro počítání počtu konfliktů (opakované hodnoty v řádcích, sloupcích a blocích)
+    int calculateConflicts() const;
+
+    // Počítání skóre tak, že za každý unikátní prvek v každém řádku a sloupci přičteme -1
+    // v 9x9 máme 9 řádků a 9 sloupců = 18 -> každý -9 -> sudoku je vyřešeno, když se hodnota rovná -162
+    // Počet unikátních prvků je popcount masky obsazených hodnot. U řádkového operátoru bloky a sloupce
+    int calculateScore() const;
+
+    // Počty výskytů hodnot a masky obsazených hodnot v řádcích, sloupcích a blocích.
+    // Díky nim se změna skóre po prohození spočítá v O(1)
+    void initCounts();
+    int lineDelta(const uint8_t * counts, int line, int removed, int added) const;
+    void addValue(int row, int col, int value, int diff);
+
+    int cell(int row, int col) const { return m_Cells[row * m_GridSize + col]; }
+    bool isFixed(int row, int col) const { return (m_FixedRows[row] >> col) & 1; }
+    int blockOf(int row, int col) const { return (row / m_BlockSize) * m_BlockSize + col / m_BlockSize; }
+
+    void swapCells(const Coord & c1, const Coord & c2);
+
+    // Kandidáti prázdné buňky - bit (value - 1) = hodnota není v řádku, sloupci ani bloku
+    uint64_t candidates(int row, int col) const;
+
+    //*****Různé kandidátní funkce:*****
+    // Vybrané buňky se uloží do m_Swapped, prohodí je až applyMove().
+    // Vybírá se vždy dvojice různých volných buněk, jen když je všechno zadané, obě souřadnice jsou stejné.
+
+    // Výběr dvou náhodných buněk v náhodném řádku.
+    // fillGrid pak vyplňuje řádky a skóre počítá sloupce a bloky místo řádků a sloupců
+    void selectCellsInRow();
+
+    // Náhodně zvolíme subgrid a vybereme dvě jeho náhodné buňky
+    void selectCellsInSubGrid();
+
+    // Náhodně zvolíme subgrid, v něm náhodně zvolíme řádek nebo sloupec a v něm vybereme dvě náhodné buňky
+    void selectCellsInSubGridRowCols();
+
+    // Tabulky volných buněk pro všechny operátory, volá se po každé změně zadaných buněk
+    void buildMoveTables();
+
+private:
+    // Kernel pevné velikosti (SudokuKernel.h) čte zadání a generátor a zapisuje výsledek zpět
+    template <int N> friend class SudokuKernel;
+
+    int m_GridSize;
+    int m_BlockSize;
+    bool PRINT_MODE;
+    bool PRINT_RESULT;
+    bool m_Propagation;
+    unsigned int m_Seed;
+    mt19937 m_Gen;
+
+    // Buňky po řádcích v jednom poli, 0 = prázdná buňka
+    array<uint8_t, MAX_SIZE * MAX_SIZE> m_Cells;
+
+    // Bit col v m_FixedRows[row] = buňka je zadaná
+    array<uint64_t, MAX_SIZE> m_FixedRows;
+
+    // Bit (value - 1) = hodnota se v řádku/sloupci/bloku vyskytuje
+    array<uint64_t, MAX_SIZE> m_RowMasks;
+    array<uint64_t, MAX_SIZE> m_ColMasks;
+    array<uint64_t, MAX_SIZE> m_BlockMasks;
+
+    // m_RowCounts[row * COUNT_STRIDE + value] = počet výskytů value v řádku, stejně pro sloupce a bloky
+    static const int COUNT_STRIDE = MAX_SIZE + 1;
+    array<uint8_t, MAX_SIZE * COUNT_STRIDE> m_RowCounts;
+    array<uint8_t, MAX_SIZE * COUNT_STRIDE> m_ColCounts;
+    array<uint8_t, MAX_SIZE * COUNT_STRIDE> m_BlockCounts;
+
+    void selectCells(const MoveTable & table);
+    void swapMove();
+
+    pair<Coord, Coord> m_Swapped;
+
+    MoveOperator m_Operator;
+    MoveTable m_BlockMoves;
+    MoveTable m_RowMoves;
+    MoveTable m_SegmentMoves;
+    MoveStats m_Stats;
+
+    RunLogger * m_Logger;
+    int m_RunNr;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------------------
+
+inline Sudoku::Sudoku(int gridSize)
+        : Sudoku(gridSize, static_cast<unsigned int>(chrono::system_clock::now().time_since_epoch().count())) {}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline Sudoku::Sudoku(int gridSize, unsigned int seed)
+        : m_GridSize(gridSize), m_BlockSize(sqrt(gridSize)), PRINT_MODE(false), PRINT_RESULT(true), m_Propagation(true),
+          m_Seed(seed), m_Gen(seed), m_Operator(MoveOperator::SUB_GRID), m_Stats{0, 0}, m_Logger(nullptr), m_RunNr(0) {
+    assert(m_GridSize <= MAX_SIZE && m_BlockSize * m_BlockSize == m_GridSize);
+
+    m_Cells.fill(0);
+    m_FixedRows.fill(0);
+    initCounts();
+    buildMoveTables();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::setInitialValues(const std::vector<std::vector<int>> &initialValues) {
+    for (int i = 0; i < m_GridSize; i++) {
+        m_FixedRows[i] = 0;
+        for (int j = 0; j < m_GridSize; ++j) {
+            m_Cells[i * m_GridSize + j] = initialValues[i][j];
+            if(initialValues[i][j] != 0)
+                m_FixedRows[i] |= 1ULL << j;
+        }
+    }
+
+    if(m_Propagation) {
+        propagate();
+    }
+
+    buildMoveTables();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::buildMoveTables() {
+    m_BlockMoves.clear();
+    m_RowMoves.clear();
+    m_SegmentMoves.clear();
+
+    auto add = [&](MoveTable & table, int row, int col) {
+        if(!isFixed(row, col)) {
+            table.m_Cells.push_back(row * m_GridSize + col);
+        }
+    };
+
+    for (int block = 0; block < m_GridSize; ++block) {
+        int blockRow = (block / m_BlockSize) * m_BlockSize;
+        int blockCol = (block % m_BlockSize) * m_BlockSize;
+
+        for (int i = 0; i < m_BlockSize; ++i) {
+            for (int j = 0; j < m_BlockSize; ++j) {
+                add(m_BlockMoves, blockRow + i, blockCol + j);
+            }
+        }
+        m_BlockMoves.closeUnit();
+
+        // Úseky řádků a pak úseky sloupců bloku
+        for (int i = 0; i < m_BlockSize; ++i) {
+            for (int j = 0; j < m_BlockSize; ++j) {
+                add(m_SegmentMoves, blockRow + i, blockCol + j);
+            }
+            m_SegmentMoves.closeUnit();
+        }
+        for (int j = 0; j < m_BlockSize; ++j) {
+            for (int i = 0; i < m_BlockSize; ++i) {
+                add(m_SegmentMoves, blockRow + i, blockCol + j);
+            }
+            m_SegmentMoves.closeUnit();
+        }
+    }
+
+    for (int row = 0; row < m_GridSize; ++row) {
+        for (int col = 0; col < m_GridSize; ++col) {
+            add(m_RowMoves, row, col);
+        }
+        m_RowMoves.closeUnit();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline uint64_t Sudoku::candidates(int row, int col) const {
+    uint64_t all = m_GridSize == 64 ? ~0ULL : (1ULL << m_GridSize) - 1;
+
+    return all & ~(m_RowMasks[row] | m_ColMasks[col] | m_BlockMasks[blockOf(row, col)]);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline int Sudoku::propagate() {
+    initCounts();
+
+    uint64_t all = m_GridSize == 64 ? ~0ULL : (1ULL << m_GridSize) - 1;
+    int forced = 0;
+    bool changed = true;
+
+    auto place = [&](int row, int col, int value) {
+        addValue(row, col, 0, -1);
+        addValue(row, col, value, 1);
+        m_Cells[row * m_GridSize + col] = value;
+        m_FixedRows[row] |= 1ULL << col;
+        forced++;
+        changed = true;
+    };
+
+    while (changed) {
+        changed = false;
+
+        // Naked singles - buňka má jediného kandidáta
+        for (int row = 0; row < m_GridSize; ++row) {
+            for (int col = 0; col < m_GridSize; ++col) {
+                if(cell(row, col) != 0) {
+                    continue;
+                }
+
+                uint64_t cand = candidates(row, col);
+                if(cand == 0) {
+                    return forced;
+                }
+                if((cand & (cand - 1)) == 0) {
+                    place(row, col, __builtin_ctzll(cand) + 1);
+                }
+            }
+        }
+
+        // Hidden singles - hodnota má v řádku, sloupci nebo bloku jediné možné místo.
+        // unit 0..N-1 jsou řádky, N..2N-1 sloupce, 2N..3N-1 bloky
+        for (int unit = 0; unit < 3 * m_GridSize; ++unit) {
+            int type = unit / m_GridSize;
+            int index = unit % m_GridSize;
+
+            auto coord = [&](int k) {
+                if(type == 0) return Coord(index, k);
+                if(type == 1) return Coord(k, index);
+                return Coord((index / m_BlockSize) * m_BlockSize + k / m_BlockSize,
+                             (index % m_BlockSize) * m_BlockSize + k % m_BlockSize);
+            };
+
+            uint64_t present = 0;
+            uint64_t once = 0;
+            uint64_t twice = 0;
+
+            for (int k = 0; k < m_GridSize; ++k) {
+                Coord c = coord(k);
+                int value = cell(c.m_Row, c.m_Col);
+
+                if(value != 0) {
+                    present |= 1ULL << (value - 1);
+                } else {
+                    uint64_t cand = candidates(c.m_Row, c.m_Col);
+                    twice |= once & cand;
+                    once |= cand;
+                }
+            }
+
+            if((all & ~present & ~once) != 0) {
+                return forced;
+            }
+
+            uint64_t hidden = once & ~twice & ~present;
+
+            for (int k = 0; k < m_GridSize && hidden; ++k) {
+                Coord c = coord(k);
+                if(cell(c.m_Row, c.m_Col) != 0) {
+                    continue;
+                }
+
+                uint64_t mine = candidates(c.m_Row, c.m_Col) & hidden;
+                if(mine == 0) {
+                    continue;
+                }
+
+                // Dvě různé skryté hodnoty pro jednu buňku = spor
+                if((mine & (mine - 1)) != 0) {
+                    return forced;
+                }
+
+                place(c.m_Row, c.m_Col, __builtin_ctzll(mine) + 1);
+                hidden &= ~mine;
+            }
+        }
+    }
+
+    return forced;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline double Sudoku::searchSpaceLog10() const {
+    double log10States = 0;
+
+    for (int block = 0; block < m_GridSize; ++block) {
+        int blockRow = (block / m_BlockSize) * m_BlockSize;
+        int blockCol = (block % m_BlockSize) * m_BlockSize;
+        int freeCells = 0;
+
+        for (int i = 0; i < m_BlockSize; ++i) {
+            for (int j = 0; j < m_BlockSize; ++j) {
+                freeCells += !isFixed(blockRow + i, blockCol + j);
+            }
+        }
+
+        log10States += lgamma(freeCells + 1) / log(10);
+    }
+
+    return log10States;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::fillGrid() {
+    vector<pair<int, int>> zeroIndices;
+    vector<int> toFill;
+
+    // Řádkový operátor prohazuje jen uvnitř řádku, proto se vyplňují řádky, ostatní operátory bloky
+    bool byRows = m_Operator == MoveOperator::ROW;
+
+    for (int unit = 0; unit < m_GridSize; unit++) {
+        int blockRow = (unit / m_BlockSize) * m_BlockSize;
+        int blockCol = (unit % m_BlockSize) * m_BlockSize;
+
+        zeroIndices.clear();
+        uint64_t presentNumbers = 0;
+
+        for (int k = 0; k < m_GridSize; k++) {
+            int row = byRows ? unit : blockRow + k / m_BlockSize;
+            int col = byRows ? k : blockCol + k % m_BlockSize;
+            int val = cell(row, col);
+            if (val != 0) {
+                presentNumbers |= 1ULL << (val - 1);
+            } else {
+                zeroIndices.emplace_back(row, col);
+            }
+        }
+
+        toFill.clear();
+        for (int num = 1; num <= m_GridSize; num++) {
+            if (!((presentNumbers >> (num - 1)) & 1)) {
+                toFill.push_back(num);
+            }
+        }
+
+        shuffle(toFill.begin(), toFill.end(), m_Gen);
+
+        for (size_t k = 0; k < zeroIndices.size(); k++) {
+            auto& [r, c] = zeroIndices[k];
+            m_Cells[r * m_GridSize + c] = toFill[k];
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::print(unsigned long step, int conflicts, double temp) {
+    string bold = "\033[1m";
+    string reset = "\033[0m";
+
+    cout << bold;
+    cout << "STEP: " << step << "               " << endl;
+    cout << "Score: " << conflicts << "               " << endl;
+    cout << "Temperature: " << temp <<    "               " << endl;
+
+    cout << reset;
+
+    int largestNumber = floor(log10(m_GridSize)) + 1;
+    string fullSeparator = "\033[1;31m+\033[0m";
+
+    int totalLength = m_GridSize * (largestNumber + 1) + 2*m_BlockSize - 1;
+    fullSeparator += string(totalLength, '-') + "\033[1;31m+\033[0m";
+
+    for (int i = 0; i < m_GridSize; ++i) {
+        if (i % m_BlockSize == 0)
+            cout << fullSeparator << endl;
+
+        for (int j = 0; j < m_GridSize; ++j) {
+            if (j % m_BlockSize == 0)
+                cout << "\033[1;31m| \033[0m";
+
+            cout << "\033[34m" << setw(largestNumber) << cell(i, j) << "\033[0m ";
+        }
+        cout << "\033[1;31m|\033[0m" << endl;
+    }
+    cout << fullSeparator << endl;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::logData(unsigned long step, int conflicts, double temp) {
+    if(m_Logger) {
+        m_Logger->log(step, conflicts, temp);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::selectCellsInRow() {
+    selectCells(m_RowMoves);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Každý řádek, sloupec a blok má (počet vyplněných buněk - počet různých hodnot) konfliktů
+inline int Sudoku::calculateConflicts() const {
+    int conflicts = 0;
+    int stride = COUNT_STRIDE;
+
+    for (int i = 0; i < m_GridSize; i++) {
+        conflicts += m_GridSize - m_RowCounts[i * stride] - __builtin_popcountll(m_RowMasks[i]);
+        conflicts += m_GridSize - m_ColCounts[i * stride] - __builtin_popcountll(m_ColMasks[i]);
+        conflicts += m_GridSize - m_BlockCounts[i * stride] - __builtin_popcountll(m_BlockMasks[i]);
+    }
+
+    return conflicts;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::swapCells(const Coord &c1, const Coord &c2) {
+    swap(m_Cells[c1.m_Row * m_GridSize + c1.m_Col], m_Cells[c2.m_Row * m_GridSize + c2.m_Col]);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline int Sudoku::calculateScore() const {
+    // Row swaps keep every row a permutation, the blocks are scored instead of the rows
+    bool byRows = m_Operator == MoveOperator::ROW;
+    const array<uint64_t, MAX_SIZE> & masks = byRows ? m_BlockMasks : m_RowMasks;
+    const array<uint8_t, MAX_SIZE * COUNT_STRIDE> & counts = byRows ? m_BlockCounts : m_RowCounts;
+    int score = 0;
+
+    for (int i = 0; i < m_GridSize; ++i) {
+        score -= __builtin_popcountll(masks[i]) + __builtin_popcountll(m_ColMasks[i]);
+    }
+
+    // Empty cells count as one unique element of their row (block) and column, same as value 0 did before
+    for (int i = 0; i < m_GridSize; ++i) {
+        score -= (counts[i * COUNT_STRIDE] != 0) + (m_ColCounts[i * COUNT_STRIDE] != 0);
+    }
+
+    return score;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::selectCellsInSubGrid() {
+    selectCells(m_BlockMoves);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Náhodná jednotka z těch, kde se dá prohazovat, a v ní dvě různé náhodné volné buňky
+inline void Sudoku::selectCells(const MoveTable & table) {
+    if(table.m_Movable.empty()) {
+        m_Swapped.first = m_Swapped.second = Coord(0, 0);
+        return;
+    }
+
+    uniform_int_distribution<> disUnit(0, table.m_Movable.size() - 1);
+    int unit = table.m_Movable[disUnit(m_Gen)];
+    int start = table.m_Start[unit];
+    int size = table.m_Start[unit + 1] - start;
+
+    uniform_int_distribution<> disFirst(0, size - 1);
+    uniform_int_distribution<> disSecond(0, size - 2);
+    int first = disFirst(m_Gen);
+    int second = disSecond(m_Gen);
+    if(second >= first) {
+        second++;
+    }
+
+    int cell1 = table.m_Cells[start + first];
+    int cell2 = table.m_Cells[start + second];
+    m_Swapped.first = Coord(cell1 / m_GridSize, cell1 % m_GridSize);
+    m_Swapped.second = Coord(cell2 / m_GridSize, cell2 % m_GridSize);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::selectCellsInSubGridRowCols() {
+    selectCells(m_SegmentMoves);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline AnnealingResult Sudoku::simulatedAnnealing() {
+    return simulatedAnnealing(GeometricSchedule(0.5, 0.99999, 5000));
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <typename Schedule>
+AnnealingResult Sudoku::simulatedAnnealing(Schedule schedule) {
+    return simulatedAnnealing(schedule, Printer{*this});
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <typename Schedule, typename Observer>
+AnnealingResult Sudoku::simulatedAnnealing(Schedule schedule, Observer observer) {
+    return annealer(schedule, observer).run();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <typename Schedule>
+AnnealingResult Sudoku::simulatedAnnealing(Schedule schedule, const string & checkpointPath, unsigned long every,
+                                           bool resume) {
+    return annealer(schedule, Printer{*this}).runCheckpointed(checkpointPath, every, resume);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::saveState(ostream & out) const {
+    uint8_t gridSize = m_GridSize;
+    uint8_t moveOperator = (uint8_t) m_Operator;
+
+    out.write(reinterpret_cast<const char *>(&gridSize), sizeof(gridSize));
+    out.write(reinterpret_cast<const char *>(&moveOperator), sizeof(moveOperator));
+    out.write(reinterpret_cast<const char *>(m_Cells.data()), m_GridSize * m_GridSize);
+    out.write(reinterpret_cast<const char *>(m_FixedRows.data()), m_GridSize * sizeof(uint64_t));
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool Sudoku::loadState(istream & in) {
+    uint8_t gridSize;
+    uint8_t moveOperator;
+    array<uint8_t, MAX_SIZE * MAX_SIZE> cells;
+    array<uint64_t, MAX_SIZE> fixedRows;
+
+    if(!in.read(reinterpret_cast<char *>(&gridSize), sizeof(gridSize)) || gridSize != m_GridSize
+       || !in.read(reinterpret_cast<char *>(&moveOperator), sizeof(moveOperator))
+       || moveOperator > (uint8_t) MoveOperator::SUB_GRID_ROW_COL
+       || !in.read(reinterpret_cast<char *>(cells.data()), m_GridSize * m_GridSize)
+       || !in.read(reinterpret_cast<char *>(fixedRows.data()), m_GridSize * sizeof(uint64_t))) {
+        return false;
+    }
+
+    m_Operator = (MoveOperator) moveOperator;
+    m_Cells = cells;
+    m_FixedRows = fixedRows;
+    initCounts();
+    buildMoveTables();
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <typename Schedule, typename Observer>
+SimulatedAnnealing<Sudoku, Schedule, mt19937, Observer> Sudoku::annealer(Schedule schedule, Observer observer) {
+    return SimulatedAnnealing<Sudoku, Schedule, mt19937, Observer>(*this, schedule, m_Gen, observer);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool Sudoku::solveExact(double budgetMs) {
+    // Jen zadané (a propagací vynucené) buňky, hodnoty z předchozího žíhání se ignorují
+    vector<uint8_t> grid(m_GridSize * m_GridSize, 0);
+    for (int row = 0; row < m_GridSize; ++row) {
+        for (int col = 0; col < m_GridSize; ++col) {
+            if(isFixed(row, col)) {
+                grid[row * m_GridSize + col] = cell(row, col);
+            }
+        }
+    }
+
+    ExactCover exact{m_GridSize, grid};
+    if(!exact.solve(grid, budgetMs)) {
+        return false;
+    }
+
+    copy(grid.begin(), grid.end(), m_Cells.begin());
+    initCounts();
+
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <typename Schedule>
+AnnealingResult Sudoku::solveHybrid(double budgetMs, Schedule schedule) {
+    if(solveExact(budgetMs)) {
+        if(PRINT_RESULT) {
+            print(0, calculateScore(), 0);
+        }
+        return {0, calculateScore(), true};
+    }
+
+    return simulatedAnnealing(schedule);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline int Sudoku::initialize() {
+    m_Stats = {0, 0};
+    fillGrid();
+    initCounts();
+
+    return calculateScore();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::initCounts() {
+    m_RowMasks.fill(0);
+    m_ColMasks.fill(0);
+    m_BlockMasks.fill(0);
+    m_RowCounts.fill(0);
+    m_ColCounts.fill(0);
+    m_BlockCounts.fill(0);
+
+    for (int row = 0; row < m_GridSize; ++row) {
+        for (int col = 0; col < m_GridSize; ++col) {
+            addValue(row, col, cell(row, col), 1);
+        }
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Adds (diff = 1) or removes (diff = -1) one occurrence of value in the lines of the cell,
+// the mask bit is kept set exactly while the count is non-zero
+inline void Sudoku::addValue(int row, int col, int value, int diff) {
+    int block = blockOf(row, col);
+
+    uint8_t & rowCount = m_RowCounts[row * COUNT_STRIDE + value];
+    uint8_t & colCount = m_ColCounts[col * COUNT_STRIDE + value];
+    uint8_t & blockCount = m_BlockCounts[block * COUNT_STRIDE + value];
+
+    rowCount += diff;
+    colCount += diff;
+    blockCount += diff;
+
+    if(value == 0) {
+        return;
+    }
+
+    uint64_t bit = 1ULL << (value - 1);
+    m_RowMasks[row] = rowCount ? (m_RowMasks[row] | bit) : (m_RowMasks[row] & ~bit);
+    m_ColMasks[col] = colCount ? (m_ColMasks[col] | bit) : (m_ColMasks[col] & ~bit);
+    m_BlockMasks[block] = blockCount ? (m_BlockMasks[block] | bit) : (m_BlockMasks[block] & ~bit);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Score change of a row/column in which one occurrence of removed is replaced by added:
+// removed value disappears from the line when it was there only once (score +1),
+// added value is new in the line when it was not there yet (score -1)
+inline int Sudoku::lineDelta(const uint8_t * counts, int line, int removed, int added) const {
+    const uint8_t * lineCounts = &counts[line * COUNT_STRIDE];
+
+    return (lineCounts[removed] == 1) - (lineCounts[added] == 0);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::proposeMove() {
+    switch (m_Operator) {
+        case MoveOperator::SUB_GRID:
+            selectCellsInSubGrid();
+            break;
+        case MoveOperator::ROW:
+            selectCellsInRow();
+            break;
+        case MoveOperator::SUB_GRID_ROW_COL:
+            selectCellsInSubGridRowCols();
+            break;
+    }
+
+    m_Stats.proposed++;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool Sudoku::isSolved(int score) const {
+    // Třetí druh jednotek (bloky, u řádkového operátoru řádky) je permutací už z fillGrid a tahy ho nemění
+    return score == -(m_GridSize*2*m_GridSize);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline int Sudoku::moveDelta() const {
+    const Coord & c1 = m_Swapped.first;
+    const Coord & c2 = m_Swapped.second;
+    int v1 = cell(c1.m_Row, c1.m_Col);
+    int v2 = cell(c2.m_Row, c2.m_Col);
+
+    if(v1 == v2) {
+        return 0;
+    }
+
+    int delta = 0;
+
+    // Cells in the same row (column) only exchange values inside it, its score does not change
+    if(c1.m_Row != c2.m_Row) {
+        delta += lineDelta(m_RowCounts.data(), c1.m_Row, v1, v2);
+        delta += lineDelta(m_RowCounts.data(), c2.m_Row, v2, v1);
+    }
+    if(c1.m_Col != c2.m_Col) {
+        delta += lineDelta(m_ColCounts.data(), c1.m_Col, v1, v2);
+        delta += lineDelta(m_ColCounts.data(), c2.m_Col, v2, v1);
+    }
+
+    // Only the row operator moves values between blocks, the other operators never get here
+    int b1 = blockOf(c1.m_Row, c1.m_Col);
+    int b2 = blockOf(c2.m_Row, c2.m_Col);
+    if(b1 != b2) {
+        delta += lineDelta(m_BlockCounts.data(), b1, v1, v2);
+        delta += lineDelta(m_BlockCounts.data(), b2, v2, v1);
+    }
+
+    return delta;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::applyMove() {
+    m_Stats.accepted++;
+    swapMove();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::swapMove() {
+    const Coord & c1 = m_Swapped.first;
+    const Coord & c2 = m_Swapped.second;
+    int v1 = cell(c1.m_Row, c1.m_Col);
+    int v2 = cell(c2.m_Row, c2.m_Col);
+
+    addValue(c1.m_Row, c1.m_Col, v1, -1);
+    addValue(c2.m_Row, c2.m_Col, v2, -1);
+    addValue(c1.m_Row, c1.m_Col, v2, 1);
+    addValue(c2.m_Row, c2.m_Col, v1, 1);
+
+    swapCells(c1, c2);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Swapping the same cells again restores both the grid and the count tables
+inline void Sudoku::revertMove() {
+    m_Stats.accepted--;
+    swapMove();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::Printer::onStart(int score) {
+    if(m_Sudoku.m_Logger) {
+        m_Sudoku.m_Logger->beginRun(m_Sudoku.m_RunNr);
+    }
+    if(m_Sudoku.PRINT_RESULT) {
+        cout << "START SCORE: " << score << endl;
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::Printer::onStep(unsigned long step, int score, double temp) {
+    if(m_Sudoku.PRINT_MODE) {
+        cout << "\033[H";
+        m_Sudoku.print(step, score, temp);
+        this_thread::sleep_for(chrono::milliseconds(50));
+    }
+    m_Sudoku.logData(step, score, temp);
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void Sudoku::Printer::onFinish(unsigned long step, int score, double temp) {
+    if(m_Sudoku.m_Logger) {
+        m_Sudoku.m_Logger->endRun(step, score, temp);
+    }
+    if(!m_Sudoku.PRINT_MODE && m_Sudoku.PRINT_RESULT) {
+        m_Sudoku.print(step, score, temp);
+    }
+}
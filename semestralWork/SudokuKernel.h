@@ -0,0 +1,267 @@
+#pragma once
+
+#include <array>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+
+#include "Sudoku.h"
+
+using namespace std;
+
+// Annealing kernel for one grid size known at compile time (9, 16, 25).
+// Same problem policy, moves (SUB_GRID operator) and random number sequence as Sudoku, so with the same seed
+// it follows exactly the same trajectory, but all sizes, loop bounds and distribution ranges are constants,
+// arrays have fixed size and cells of every block are listed in a table computed at compile time.
+// Kernel works on a copy of the grid and writes the result back to its Sudoku after the run.
+// A step is O(1) without loops and mostly spent in the random number generator, so the gain over the dynamic
+// Sudoku is modest (1.0-1.4x in --bench-kernels).
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <int N>
+class SudokuKernel {
+public:
+    static constexpr int BLOCK = N == 9 ? 3 : N == 16 ? 4 : N == 25 ? 5 : N == 36 ? 6 : N == 49 ? 7 : N == 64 ? 8 : 0;
+    static_assert(BLOCK > 0, "grid size must be a square up to 64");
+
+    SudokuKernel(Sudoku & sudoku);
+
+    template <typename Schedule, typename Observer>
+    SimulatedAnnealing<SudokuKernel<N>, Schedule, mt19937, Observer> annealer(Schedule schedule, Observer observer) {
+        return SimulatedAnnealing<SudokuKernel<N>, Schedule, mt19937, Observer>(*this, schedule, m_Sudoku.m_Gen, observer);
+    }
+
+    // Copies the grid back to the Sudoku
+    void writeBack();
+
+    // Problem policy for SimulatedAnnealing, see Sudoku
+    static constexpr bool SCORE_BEFORE_APPLY = true;
+    int initialize();
+    void proposeMove();
+    int moveDelta() const;
+    void applyMove();
+    void revertMove() { applyMove(); }
+    bool isSolved(int score) const { return score == -(2 * N * N); }
+
+private:
+    static constexpr int STRIDE = N + 1;
+
+    // BLOCK_CELLS[block][k] = index of k-th cell of the block, row by row
+    struct BlockTable {
+        array<array<uint16_t, N>, N> m_Cells;
+
+        constexpr BlockTable() : m_Cells() {
+            for (int block = 0; block < N; ++block) {
+                for (int k = 0; k < N; ++k) {
+                    int row = (block / BLOCK) * BLOCK + k / BLOCK;
+                    int col = (block % BLOCK) * BLOCK + k % BLOCK;
+                    m_Cells[block][k] = row * N + col;
+                }
+            }
+        }
+    };
+    static constexpr BlockTable BLOCK_CELLS = BlockTable();
+
+    void addValue(int index, int value, int diff);
+
+    Sudoku & m_Sudoku;
+
+    array<uint8_t, N * N> m_Cells;
+
+    // Copy of the Sudoku's block move table
+    array<uint16_t, N * N> m_FreeCells;
+    array<uint16_t, N + 1> m_FreeStart;
+    array<uint8_t, N> m_Movable;
+    int m_MovableCount;
+
+    array<uint8_t, N * STRIDE> m_RowCounts;
+    array<uint8_t, N * STRIDE> m_ColCounts;
+
+    int m_First;
+    int m_Second;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <int N>
+SudokuKernel<N>::SudokuKernel(Sudoku & sudoku) : m_Sudoku(sudoku), m_First(0), m_Second(0) {
+    for (int i = 0; i < N * N; ++i) {
+        m_Cells[i] = sudoku.cell(i / N, i % N);
+    }
+
+    const MoveTable & blocks = sudoku.m_BlockMoves;
+    copy(blocks.m_Cells.begin(), blocks.m_Cells.end(), m_FreeCells.begin());
+    copy(blocks.m_Start.begin(), blocks.m_Start.end(), m_FreeStart.begin());
+    copy(blocks.m_Movable.begin(), blocks.m_Movable.end(), m_Movable.begin());
+    m_MovableCount = blocks.m_Movable.size();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <int N>
+void SudokuKernel<N>::writeBack() {
+    for (int i = 0; i < N * N; ++i) {
+        m_Sudoku.m_Cells[i] = m_Cells[i];
+    }
+    m_Sudoku.initCounts();
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <int N>
+inline void SudokuKernel<N>::addValue(int index, int value, int diff) {
+    m_RowCounts[(index / N) * STRIDE + value] += diff;
+    m_ColCounts[(index % N) * STRIDE + value] += diff;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Same as Sudoku::fillGrid + initCounts + calculateScore
+template <int N>
+int SudokuKernel<N>::initialize() {
+    for (int block = 0; block < N; ++block) {
+        const auto & cells = BLOCK_CELLS.m_Cells[block];
+        uint64_t present = 0;
+
+        for (int k = 0; k < N; ++k) {
+            if(m_Cells[cells[k]] != 0) {
+                present |= 1ULL << (m_Cells[cells[k]] - 1);
+            }
+        }
+
+        array<uint8_t, N> toFill;
+        int count = 0;
+        for (int value = 1; value <= N; ++value) {
+            if(!((present >> (value - 1)) & 1)) {
+                toFill[count++] = value;
+            }
+        }
+
+        shuffle(toFill.begin(), toFill.begin() + count, m_Sudoku.m_Gen);
+
+        int next = 0;
+        for (int k = 0; k < N; ++k) {
+            if(m_Cells[cells[k]] == 0) {
+                m_Cells[cells[k]] = toFill[next++];
+            }
+        }
+    }
+
+    m_RowCounts.fill(0);
+    m_ColCounts.fill(0);
+    for (int i = 0; i < N * N; ++i) {
+        addValue(i, m_Cells[i], 1);
+    }
+
+    int score = 0;
+    for (int line = 0; line < N; ++line) {
+        for (int value = 0; value <= N; ++value) {
+            score -= (m_RowCounts[line * STRIDE + value] != 0) + (m_ColCounts[line * STRIDE + value] != 0);
+        }
+    }
+
+    return score;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Same as Sudoku::selectCellsInSubGrid
+template <int N>
+inline void SudokuKernel<N>::proposeMove() {
+    if(m_MovableCount == 0) {
+        m_First = m_Second = 0;
+        return;
+    }
+
+    uniform_int_distribution<> disUnit(0, m_MovableCount - 1);
+    int block = m_Movable[disUnit(m_Sudoku.m_Gen)];
+    int start = m_FreeStart[block];
+    int size = m_FreeStart[block + 1] - start;
+
+    uniform_int_distribution<> disFirst(0, size - 1);
+    uniform_int_distribution<> disSecond(0, size - 2);
+    int first = disFirst(m_Sudoku.m_Gen);
+    int second = disSecond(m_Sudoku.m_Gen);
+    if(second >= first) {
+        second++;
+    }
+
+    m_First = m_FreeCells[start + first];
+    m_Second = m_FreeCells[start + second];
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <int N>
+inline int SudokuKernel<N>::moveDelta() const {
+    int v1 = m_Cells[m_First];
+    int v2 = m_Cells[m_Second];
+
+    if(v1 == v2) {
+        return 0;
+    }
+
+    int r1 = m_First / N, c1 = m_First % N;
+    int r2 = m_Second / N, c2 = m_Second % N;
+    int delta = 0;
+
+    if(r1 != r2) {
+        delta += (m_RowCounts[r1 * STRIDE + v1] == 1) - (m_RowCounts[r1 * STRIDE + v2] == 0);
+        delta += (m_RowCounts[r2 * STRIDE + v2] == 1) - (m_RowCounts[r2 * STRIDE + v1] == 0);
+    }
+    if(c1 != c2) {
+        delta += (m_ColCounts[c1 * STRIDE + v1] == 1) - (m_ColCounts[c1 * STRIDE + v2] == 0);
+        delta += (m_ColCounts[c2 * STRIDE + v2] == 1) - (m_ColCounts[c2 * STRIDE + v1] == 0);
+    }
+
+    return delta;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <int N>
+inline void SudokuKernel<N>::applyMove() {
+    int v1 = m_Cells[m_First];
+    int v2 = m_Cells[m_Second];
+
+    addValue(m_First, v1, -1);
+    addValue(m_Second, v2, -1);
+    addValue(m_First, v2, 1);
+    addValue(m_Second, v1, 1);
+
+    m_Cells[m_First] = v2;
+    m_Cells[m_Second] = v1;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+template <int N, typename Schedule, typename Observer>
+AnnealingResult annealKernel(Sudoku & sudoku, Schedule schedule, Observer observer) {
+    SudokuKernel<N> kernel{sudoku};
+    AnnealingResult result = kernel.annealer(schedule, observer).run();
+    kernel.writeBack();
+
+    return result;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+// Picks the kernel for the grid size, other sizes and operators run on the dynamic Sudoku
+template <typename Schedule, typename Observer = NullObserver>
+AnnealingResult annealFixedSize(Sudoku & sudoku, Schedule schedule, Observer observer = Observer()) {
+    if(sudoku.getMoveOperator() != MoveOperator::SUB_GRID) {
+        return sudoku.simulatedAnnealing(schedule, observer);
+    }
+
+    switch (sudoku.getGridSize()) {
+        case 9:
+            return annealKernel<9>(sudoku, schedule, observer);
+        case 16:
+            return annealKernel<16>(sudoku, schedule, observer);
+        case 25:
+            return annealKernel<25>(sudoku, schedule, observer);
+        default:
+            return sudoku.simulatedAnnealing(schedule, observer);
+    }
+}
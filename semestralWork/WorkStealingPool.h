@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <memory>
+
+using namespace std;
+
+// Runs tasks 0..taskCount-1 on a fixed number of workers.
+// Every worker has its own deque, takes tasks from its back and when it runs dry steals from the front
+// of the other deques, so long puzzles on one worker do not leave the others idle.
+
+//-------------------------------------------------------------------------------------------------------------
+
+class WorkStealingPool {
+public:
+    WorkStealingPool(int workers);
+
+    int getWorkers() const { return m_Workers; }
+
+    // task(taskIndex, workerIndex), returns after all tasks finished
+    void run(size_t taskCount, const function<void(size_t, int)> & task);
+
+private:
+    struct WorkQueue {
+        mutex m_Lock;
+        deque<size_t> m_Tasks;
+    };
+
+    bool popLocal(int worker, size_t & task);
+    bool steal(int worker, size_t & task);
+    void workerLoop(int worker, const function<void(size_t, int)> & task);
+
+    int m_Workers;
+    vector<unique_ptr<WorkQueue>> m_Queues;
+};
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline WorkStealingPool::WorkStealingPool(int workers) : m_Workers(workers > 0 ? workers : 1) {
+    for (int i = 0; i < m_Workers; ++i) {
+        m_Queues.push_back(make_unique<WorkQueue>());
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void WorkStealingPool::run(size_t taskCount, const function<void(size_t, int)> & task) {
+    // Round robin, so every worker starts with a share of the work
+    for (size_t i = 0; i < taskCount; ++i) {
+        m_Queues[i % m_Workers]->m_Tasks.push_back(i);
+    }
+
+    vector<thread> threads;
+    for (int worker = 1; worker < m_Workers; ++worker) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, worker, cref(task));
+    }
+
+    // Calling thread is worker 0
+    workerLoop(0, task);
+
+    for (auto & t : threads) {
+        t.join();
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool WorkStealingPool::popLocal(int worker, size_t & task) {
+    WorkQueue & queue = *m_Queues[worker];
+    lock_guard<mutex> guard(queue.m_Lock);
+
+    if(queue.m_Tasks.empty()) {
+        return false;
+    }
+
+    task = queue.m_Tasks.back();
+    queue.m_Tasks.pop_back();
+    return true;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline bool WorkStealingPool::steal(int worker, size_t & task) {
+    for (int i = 1; i < m_Workers; ++i) {
+        WorkQueue & victim = *m_Queues[(worker + i) % m_Workers];
+        lock_guard<mutex> guard(victim.m_Lock);
+
+        if(!victim.m_Tasks.empty()) {
+            task = victim.m_Tasks.front();
+            victim.m_Tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//-------------------------------------------------------------------------------------------------------------
+
+inline void WorkStealingPool::workerLoop(int worker, const function<void(size_t, int)> & task) {
+    size_t current;
+
+    // Tasks are never added during a run, so empty queues everywhere mean this worker is done
+    while (popLocal(worker, current) || steal(worker, current)) {
+        task(current, worker);
+    }
+}
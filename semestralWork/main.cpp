@@ -1,472 +1,332 @@
 #include <iostream>
+#include <fstream>
 #include <vector>
-#include <set>
 #include <string>
-#include <random>
 #include <cmath>
 #include <iomanip>
-#include <unordered_set>
-#include <thread>
-#include <fstream>
+#include <chrono>
 #include <algorithm>
+#include <cstring>
 
-using namespace std;
-
-//-------------------------------------------------------------------------------------------------------------
-
-struct IterationData {
-    int conflicts;
-    double temperature;
-    unsigned long step;
-
-};
-
-//-------------------------------------------------------------------------------------------------------------
-
-struct Coord {
-    int m_Row;
-    int m_Col;
-
-    Coord(int row, int col) {
-     m_Row = row;
-     m_Col = col;
-    }
-
-    Coord() : m_Row(0), m_Col(0) {};
-};
-
-//-------------------------------------------------------------------------------------------------------------
-//-------------------------------------------------------------------------------------------------------------
-
-class Sudoku {
-public:
-    Sudoku(int gridSize);
-
-    void setInitialValues(const vector<vector<int>> & initialValues);
-    double getRandomDouble();
-
-    void simulatedAnnealing();
-    double computeProba(int fx, int fy, double t);
-
-    void fillGrid();
-    void print(unsigned long step, int conflicts, double temp);
-    void logData(unsigned long step, int conflicts, double temp);
-    void writeToFile(const string & path, int runNr);
-
-    // Funkce pro počítání počtu konfliktů
-    int calculateConflicts();
-    int conflictsInLine(const vector<int>& line, unordered_set<int> &seen);
-    int conflictsInBlock(int startRow, int startCol, int blockSize, unordered_set<int> &seen);
-
-    // Počítání skóre tak, že za každý unikátní prvek v každém řádku a sloupci přičteme -1
-    // v 9x9 máme 9 řádků a 9 sloupců = 18 -> každý -9 -> sudoku je vyřešeno, když se hodnota rovná -162
-    int calculateScore(const vector<vector<int>>& grid);
-
-    void revertSwappedCells(Coord & c1, Coord & c2);
-
-    //*****Různé kandidátní funkce:*****
+#include "Sudoku.h"
+#include "BatchSolver.h"
+#include "ParallelTempering.h"
+#include "SudokuKernel.h"
 
-    // Prohození dvou náhodných buněk v náhodném řádku
-    void swapCellsInRow();
-
-    // Náhodně zvolíme subgrid a prohodíme dvě jeho náhodné buňky
-    void swapCellsInSubGrid();
-
-    // Náhodně zvolíme subgrid, v něm náhodně zvolíme řádek nebo sloupec a v něm prohodíme dvě náhodné buňky
-    void swapCellsInSubGridRowCols();
-
-private:
-    int m_GridSize;
-    int m_BlockSize;
-    bool PRINT_MODE;
-    mt19937 m_Gen;
-
-    vector<vector<int>> m_Grid;
-    vector<vector<bool>> m_Fixed;
-
-    pair<Coord, Coord> m_Swapped;
-    vector<IterationData> m_RunLog;
-};
+using namespace std;
 
 //-------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------------------
 
-Sudoku::Sudoku(int gridSize) : m_GridSize(gridSize), m_BlockSize(sqrt(gridSize)), PRINT_MODE(false) {
-    m_Grid.resize(m_GridSize);
-    m_Fixed.resize(m_GridSize);
+double percentile(vector<double> values, double p) {
+    if(values.empty()) return 0;
 
-    for (int i = 0; i < m_GridSize; ++i) {
-        m_Grid[i].resize(m_GridSize);
-        m_Fixed[i].resize(m_GridSize);
-
-        fill(m_Grid[i].begin(), m_Grid[i].end(), 0);
-        fill(m_Fixed[i].begin(), m_Fixed[i].end(), 0);
-    }
-
-    auto seed = static_cast<unsigned int>(chrono::system_clock::now().time_since_epoch().count());
-    m_Gen.seed(seed);
+    sort(values.begin(), values.end());
+    size_t idx = (size_t) ceil(p * values.size()) - 1;
 
+    return values[min(idx, values.size() - 1)];
 }
 
 //-------------------------------------------------------------------------------------------------------------
 
-double Sudoku::getRandomDouble() {
-    uniform_real_distribution<> distr(0.0, 1.0);
-
-    return distr(m_Gen);
-}
-
-//-------------------------------------------------------------------------------------------------------------
-
-void Sudoku::setInitialValues(const std::vector<std::vector<int>> &initialValues) {
-    for(size_t i = 0; i < (size_t) m_GridSize; i++) {
-        for (size_t j = 0; j < (size_t) m_GridSize; ++j) {
-            m_Grid[i][j] = initialValues[i][j];
-            if(m_Grid[i][j] != 0)
-                m_Fixed[i][j] = true;
+// Runs one schedule with seeds 0..runs-1 and prints time-to-solution distribution
+template <typename Schedule>
+void benchmarkSchedule(const string & name, const vector<vector<int>> & puzzle, const Schedule & schedule, int runs) {
+    int solved = 0;
+    vector<double> ms;
+    vector<double> steps;
+
+    for (int seed = 0; seed < runs; ++seed) {
+        Sudoku sudoku{(int) puzzle.size(), (unsigned int) seed};
+        sudoku.setPrintMode(false, false);
+        sudoku.setPropagation(false);
+        sudoku.setInitialValues(puzzle);
+
+        auto start = chrono::steady_clock::now();
+        AnnealingResult result = sudoku.simulatedAnnealing(schedule);
+        auto end = chrono::steady_clock::now();
+
+        if(result.solved) {
+            solved++;
         }
+        steps.push_back(result.steps);
+        ms.push_back(chrono::duration<double, milli>(end - start).count());
     }
+
+    cout << setw(14) << name << setw(12) << schedule.name()
+         << setw(8) << solved << "/" << runs
+         << setw(14) << fixed << setprecision(0) << percentile(steps, 0.5)
+         << setw(12) << setprecision(2) << percentile(ms, 0.5)
+         << setw(12) << percentile(ms, 0.9) << endl;
 }
 
 //-------------------------------------------------------------------------------------------------------------
 
-void Sudoku::fillGrid() {
-    for (int blockNum = 0; blockNum < m_GridSize; blockNum++) {
-        int blockRow = (blockNum / m_BlockSize) * m_BlockSize;
-        int blockCol = (blockNum % m_BlockSize) * m_BlockSize;
-
-        vector<pair<int, int>> zeroIndices;
-        set<int> presentNumbers;
-
-        for (int i = 0; i < m_BlockSize; i++) {
-            for (int j = 0; j < m_BlockSize; j++) {
-                int val = m_Grid[blockRow + i][blockCol + j];
-                if (val != 0) {
-                    presentNumbers.insert(val);
-                } else {
-                    zeroIndices.emplace_back(blockRow + i, blockCol + j);
-                }
-            }
-        }
-
-        vector<int> toFill;
-        for (int num = 1; num <= m_GridSize; num++) {
-            if (presentNumbers.find(num) == presentNumbers.end()) {
-                toFill.push_back(num);
-            }
-        }
-
-        shuffle(toFill.begin(), toFill.end(), m_Gen);
-
-        for (size_t k = 0; k < zeroIndices.size(); k++) {
-            auto& [r, c] = zeroIndices[k];
-            m_Grid[r][c] = toFill[k];
-        }
-    }
+void benchmarkSchedules(const string & name, const vector<vector<int>> & puzzle, int runs) {
+    benchmarkSchedule(name, puzzle, GeometricSchedule(0.5, 0.99999, 5000), runs);
+    benchmarkSchedule(name, puzzle, AdaptiveSchedule(0.5, 0.3, 50, 5000), runs);
+    benchmarkSchedule(name, puzzle, ReheatingSchedule(0.5, 0.99999, 5000, 0.5, 20), runs);
 }
 
 //-------------------------------------------------------------------------------------------------------------
 
-void Sudoku::print(unsigned long step, int conflicts, double temp) {
-    string bold = "\033[1m";
-    string reset = "\033[0m";
+// Search space and annealing time without and with constraint propagation before fillGrid
+void benchmarkPropagation(const string & name, const vector<vector<int>> & puzzle, int runs) {
+    int gridSize = (int) puzzle.size();
+
+    Sudoku plain{gridSize, 0};
+    plain.setPropagation(false);
+    plain.setInitialValues(puzzle);
 
-    cout << bold;
-    cout << "STEP: " << step << "               " << endl;
-    cout << "Score: " << conflicts << "               " << endl;
-    cout << "Temperature: " << temp <<    "               " << endl;
+    Sudoku propagated{gridSize, 0};
+    propagated.setInitialValues(puzzle);
 
-    cout << reset;
+    cout << setw(14) << name << setw(10) << fixed << setprecision(1) << plain.searchSpaceLog10()
+         << setw(10) << propagated.searchSpaceLog10();
 
-    int largestNumber = floor(log10(m_GridSize)) + 1;
-    string fullSeparator = "\033[1;31m+\033[0m";
+    for (bool propagation : {false, true}) {
+        int solved = 0;
+        vector<double> ms;
 
-    int totalLength = m_GridSize * (largestNumber + 1) + 2*m_BlockSize - 1;
-    fullSeparator += string(totalLength, '-') + "\033[1;31m+\033[0m";
+        for (int seed = 0; seed < runs; ++seed) {
+            auto start = chrono::steady_clock::now();
 
-    for (int i = 0; i < m_GridSize; ++i) {
-        if (i % m_BlockSize == 0)
-            cout << fullSeparator << endl;
+            Sudoku sudoku{gridSize, (unsigned int) seed};
+            sudoku.setPrintMode(false, false);
+            sudoku.setPropagation(propagation);
+            sudoku.setInitialValues(puzzle);
+            AnnealingResult result = sudoku.simulatedAnnealing(ReheatingSchedule(0.5, 0.99999, 5000, 0.5, 20));
 
-        for (int j = 0; j < m_GridSize; ++j) {
-            if (j % m_BlockSize == 0)
-                cout << "\033[1;31m| \033[0m";
+            auto end = chrono::steady_clock::now();
 
-            cout << "\033[34m" << setw(largestNumber) << m_Grid[i][j] << "\033[0m ";
+            if(result.solved) {
+                solved++;
+            }
+            ms.push_back(chrono::duration<double, milli>(end - start).count());
         }
-        cout << "\033[1;31m|\033[0m" << endl;
-    }
-    cout << fullSeparator << endl;
-}
 
-//-------------------------------------------------------------------------------------------------------------
+        cout << setw(8) << solved << "/" << runs << setw(12) << setprecision(2) << percentile(ms, 0.5);
+    }
 
-void Sudoku::logData(unsigned long step, int conflicts, double temp) {
-    m_RunLog.push_back({conflicts, temp, step});
+    cout << endl;
 }
 
 //-------------------------------------------------------------------------------------------------------------
 
-double Sudoku::computeProba(int fx, int fy, double t) {
-    int delta = fy - fx;
-
-    return exp(-delta / t);
-}
+// Exact solver, annealing and hybrid (exact with budget, then annealing) on one puzzle
+void benchmarkHybrid(const string & name, const vector<vector<int>> & puzzle, double budgetMs) {
+    int gridSize = (int) puzzle.size();
+    ReheatingSchedule schedule{0.5, 0.99999, 5000, 0.5, 20};
 
-//-------------------------------------------------------------------------------------------------------------
+    auto run = [&](int engine, bool & solved) {
+        Sudoku sudoku{gridSize, 0};
+        sudoku.setPrintMode(false, false);
 
-inline void Sudoku::swapCellsInRow() {
-    uniform_int_distribution<> disRow(0, m_GridSize - 1);
-    int row = disRow(m_Gen);
+        auto start = chrono::steady_clock::now();
+        sudoku.setInitialValues(puzzle);
 
-    // Collect all non-fixed column indices in the selected row
-    vector<int> nonFixedCols;
-    for (int col = 0; col < m_GridSize; col++) {
-        if (!m_Fixed[row][col]) {
-            nonFixedCols.push_back(col);
+        if(engine == 0) {
+            solved = sudoku.solveExact(-1);
+        } else if(engine == 1) {
+            solved = sudoku.simulatedAnnealing(schedule).solved;
+        } else {
+            AnnealingResult result = sudoku.solveHybrid(budgetMs, schedule);
+            solved = result.solved;
+            engine = result.steps == 0 ? 0 : 1;
         }
-    }
 
-    if (nonFixedCols.size() > 1) {
-        shuffle(nonFixedCols.begin(), nonFixedCols.end(), m_Gen);
+        auto end = chrono::steady_clock::now();
 
-        int col1 = nonFixedCols[0];
-        int col2 = nonFixedCols[1];
-        swap(m_Grid[row][col1], m_Grid[row][col2]);
+        cout << setw(6) << (solved ? "yes" : "no") << setw(12) << fixed << setprecision(2)
+             << chrono::duration<double, milli>(end - start).count();
+        return engine;
+    };
 
-        m_Swapped.first.m_Row = m_Swapped.second.m_Row = row;
-        m_Swapped.first.m_Col = col1;
-        m_Swapped.second.m_Col = col2;
-    }
+    bool solved;
+    cout << setw(20) << name;
+    run(0, solved);
+    run(1, solved);
+    int used = run(2, solved);
+    cout << setw(12) << (used == 0 ? "exact" : "annealing") << endl;
 }
 
 //-------------------------------------------------------------------------------------------------------------
 
-inline int Sudoku::calculateConflicts() {
-    int conflicts = 0;
-    vector<int> column(m_GridSize);
-    unordered_set<int> seen;
-
-    for (int i = 0; i < m_GridSize; i++) {
-        conflicts += conflictsInLine(m_Grid[i], seen);
-        for (int j = 0; j < m_GridSize; j++) {
-            column[j] = m_Grid[j][i];
-        }
-        conflicts += conflictsInLine(column, seen);
-    }
-
-    for (int blockRow = 0; blockRow < m_BlockSize; blockRow++) {
-        for (int blockCol = 0; blockCol < m_BlockSize; blockCol++) {
-            conflicts += conflictsInBlock(blockRow * m_BlockSize, blockCol * m_BlockSize, m_BlockSize, seen);
+// Steps per second of the dynamic Sudoku and the fixed-size kernel at constant temperature,
+// plus a check that both follow the same trajectory with the same seed
+template <int N>
+void benchmarkKernel(const string & name, const vector<vector<int>> & puzzle, unsigned long steps) {
+    double stepsPerSecond[2];
+
+    for (int kernel = 0; kernel < 2; ++kernel) {
+        Sudoku sudoku{N, 0};
+        sudoku.setPropagation(false);
+        sudoku.setInitialValues(puzzle);
+
+        auto start = chrono::steady_clock::now();
+        unsigned long done;
+
+        if(kernel) {
+            SudokuKernel<N> fixedSize{sudoku};
+            auto annealer = fixedSize.annealer(ConstantSchedule(0.5), NullObserver());
+            annealer.start();
+            annealer.advance(steps);
+            done = annealer.steps();
+        } else {
+            auto annealer = sudoku.annealer(ConstantSchedule(0.5), NullObserver());
+            annealer.start();
+            annealer.advance(steps);
+            done = annealer.steps();
         }
-    }
-
-    return conflicts;
-}
 
-//-------------------------------------------------------------------------------------------------------------
-
-inline int Sudoku::conflictsInLine(const vector<int> &line, unordered_set<int> &seen) {
-    int conflict = 0;
-    seen.clear();
-
-    for (int num : line) {
-        if (num != 0 && !seen.insert(num).second) {
-            conflict++;
-        }
+        auto end = chrono::steady_clock::now();
+        stepsPerSecond[kernel] = done / chrono::duration<double>(end - start).count();
     }
-    return conflict;
-}
 
-//-------------------------------------------------------------------------------------------------------------
+    AnnealingResult results[2];
+    for (int kernel = 0; kernel < 2; ++kernel) {
+        Sudoku sudoku{N, 1};
+        sudoku.setPrintMode(false, false);
+        sudoku.setPropagation(false);
+        sudoku.setInitialValues(puzzle);
 
-inline int Sudoku::conflictsInBlock(int startRow, int startCol, int blockSize, unordered_set<int> &seen) {
-    seen.clear();
-    int conflict = 0;
-    for (int i = 0; i < blockSize; i++) {
-        for (int j = 0; j < blockSize; j++) {
-            int num = m_Grid[startRow + i][startCol + j];
-            if (num != 0 && !seen.insert(num).second) {
-                conflict++;
-            }
-        }
+        GeometricSchedule schedule{0.5, 0.99999, 5000};
+        results[kernel] = kernel ? annealFixedSize(sudoku, schedule) : sudoku.simulatedAnnealing(schedule, NullObserver());
     }
-    return conflict;
-}
 
-//-------------------------------------------------------------------------------------------------------------
+    bool same = results[0].steps == results[1].steps && results[0].score == results[1].score;
 
-void Sudoku::revertSwappedCells(Coord &c1, Coord &c2) {
-    swap(m_Grid[c1.m_Row][c1.m_Col], m_Grid[c2.m_Row][c2.m_Col]);
+    cout << setw(14) << name << setw(6) << N << setw(16) << fixed << setprecision(0) << stepsPerSecond[0]
+         << setw(16) << stepsPerSecond[1] << setw(10) << setprecision(2) << stepsPerSecond[1] / stepsPerSecond[0]
+         << setw(16) << (same ? "yes" : "no") << endl;
 }
 
 //-------------------------------------------------------------------------------------------------------------
 
-int Sudoku::calculateScore(const vector<vector<int>> &grid) {
-    int score = 0;
-    unordered_set<int> elements;
-
-    // Check rows
-    for (const auto& row : grid) {
-        elements.clear();
-        elements.insert(row.begin(), row.end());
-        score -= elements.size();
-    }
-
-    // Check columns
-    for (size_t col = 0; col < grid.size(); ++col) {
-        elements.clear();
-        for (size_t row = 0; row < grid.size(); ++row) {
-            elements.insert(grid[row][col]);
+// Steps per second, acceptance ratio and time-to-solution of every move operator
+void benchmarkOperators(const string & name, const vector<vector<int>> & puzzle, int runs) {
+    const pair<MoveOperator, string> operators[] = {{MoveOperator::SUB_GRID, "sub-grid"}, {MoveOperator::ROW, "row"},
+                                                    {MoveOperator::SUB_GRID_ROW_COL, "segment"}};
+
+    for (const auto & [moveOperator, operatorName] : operators) {
+        int solved = 0;
+        unsigned long steps = 0;
+        unsigned long proposed = 0;
+        unsigned long accepted = 0;
+        double totalMs = 0;
+        vector<double> ms;
+
+        for (int seed = 0; seed < runs; ++seed) {
+            Sudoku sudoku{(int) puzzle.size(), (unsigned int) seed};
+            sudoku.setPrintMode(false, false);
+            sudoku.setPropagation(false);
+            sudoku.setMoveOperator(moveOperator);
+            sudoku.setInitialValues(puzzle);
+
+            auto start = chrono::steady_clock::now();
+            AnnealingResult result = sudoku.simulatedAnnealing(GeometricSchedule(0.5, 0.99999, 5000), NullObserver());
+            auto end = chrono::steady_clock::now();
+
+            solved += result.solved;
+            steps += result.steps;
+            proposed += sudoku.moveStats().proposed;
+            accepted += sudoku.moveStats().accepted;
+            ms.push_back(chrono::duration<double, milli>(end - start).count());
+            totalMs += ms.back();
         }
-        score -= elements.size();
-    }
-
-    return score;
-}
-
-//-------------------------------------------------------------------------------------------------------------
 
-inline void Sudoku::swapCellsInSubGrid() {
-    uniform_int_distribution<> disBlock(0, m_BlockSize - 1);
-
-    int blockRow = disBlock(m_Gen) * m_BlockSize;
-    int blockCol = disBlock(m_Gen) * m_BlockSize;
-
-    vector<pair<int, int>> candidates;
-
-    for (int i = 0; i < m_BlockSize; ++i) {
-        for (int j = 0; j < m_BlockSize; ++j) {
-            if (!m_Fixed[blockRow + i][blockCol + j]) {
-                candidates.emplace_back(blockRow + i, blockCol + j);
-            }
-        }
-    }
-
-    if (candidates.size() > 1) {
-        uniform_int_distribution<> dis(0, candidates.size() - 1);
-        int first = dis(m_Gen);
-        int second = dis(m_Gen);
-        while (second == first) {
-            second = dis(m_Gen);
-        }
-        swap(m_Grid[candidates[first].first][candidates[first].second],
-             m_Grid[candidates[second].first][candidates[second].second]);
-
-        m_Swapped.first.m_Row = candidates[first].first;
-        m_Swapped.second.m_Row = candidates[second].first;
-        m_Swapped.first.m_Col = candidates[first].second;
-        m_Swapped.second.m_Col = candidates[second].second;
+        cout << setw(14) << name << setw(10) << operatorName
+             << setw(8) << solved << "/" << runs
+             << setw(14) << fixed << setprecision(0) << steps / (totalMs / 1000)
+             << setw(12) << setprecision(3) << (proposed ? (double) accepted / proposed : 0)
+             << setw(12) << setprecision(2) << percentile(ms, 0.5) << endl;
     }
 }
 
 //-------------------------------------------------------------------------------------------------------------
 
-inline void Sudoku::swapCellsInSubGridRowCols() {
-    uniform_int_distribution<> blockDist(0, m_BlockSize - 1);
-    uniform_int_distribution<> flipCoin(0, 1);
+// Time-to-solution of parallel tempering against a single reheating chain with the same seeds
+void benchmarkTempering(const string & name, const vector<vector<int>> & puzzle, int runs, int replicas) {
+    int solved = 0;
+    vector<double> ms;
+    vector<double> acceptance(replicas - 1, 0);
 
-    int blockRow = blockDist(m_Gen) * m_BlockSize;
-    int blockCol = blockDist(m_Gen) * m_BlockSize;
+    for (int seed = 0; seed < runs; ++seed) {
+        TemperingOptions options;
+        options.replicas = replicas;
+        options.seed = seed;
 
-    // Decide to swap within row or column
-    if (flipCoin(m_Gen) == 0) {
-        int row = blockRow + blockDist(m_Gen);
-        int col1 = blockCol + blockDist(m_Gen);
-        int col2 = (col1 + blockDist(m_Gen) % (m_BlockSize - 1) + 1) % m_BlockSize + blockCol;
+        ParallelTempering tempering{puzzle, options};
+        TemperingResult result = tempering.run();
 
-        if (!m_Fixed[row][col1] && !m_Fixed[row][col2]) {
-            swap(m_Grid[row][col1], m_Grid[row][col2]);
-            m_Swapped.first.m_Row = m_Swapped.second.m_Row = row;
-            m_Swapped.first.m_Col = col1;
-            m_Swapped.second.m_Col = col2;
+        if(result.solved) {
+            solved++;
         }
-    } else {
-        int col = blockCol + blockDist(m_Gen);
-        int row1 = blockRow + blockDist(m_Gen);
-        int row2 = (row1 + blockDist(m_Gen) % (m_BlockSize - 1) + 1) % m_BlockSize + blockRow;
-
-        if (!m_Fixed[row1][col] && !m_Fixed[row2][col]) {
-            swap(m_Grid[row1][col], m_Grid[row2][col]);
-            m_Swapped.first.m_Row = row1;
-            m_Swapped.second.m_Row = row2;
-            m_Swapped.first.m_Col = m_Swapped.second.m_Col = col;
+        ms.push_back(result.ms);
+        for (int i = 0; i < replicas - 1; ++i) {
+            acceptance[i] += result.swapAcceptance[i] / runs;
         }
     }
-}
-
-//-------------------------------------------------------------------------------------------------------------
-
-void Sudoku::simulatedAnnealing() {
-    double temp = 0.5;
-    double coolingRate = 0.99999;
-
-    // Iterations without improvement before termination
-    int stagnationLimit = 5000;
-
-    // Track last improvement
-    int lastImprovement = 0;
-
-    fillGrid();
-    int conflicts = calculateScore(m_Grid);
-    unsigned long step = 0;
-
-    cout << "START SCORE: " << conflicts << endl;
 
-    while (lastImprovement < stagnationLimit) {
-        swapCellsInSubGrid();
+    cout << setw(14) << name << setw(12) << "tempering"
+         << setw(8) << solved << "/" << runs
+         << setw(12) << fixed << setprecision(2) << percentile(ms, 0.5)
+         << setw(12) << percentile(ms, 0.9) << "   swaps:";
+    for (double a : acceptance) {
+        cout << " " << setprecision(2) << a;
+    }
+    cout << endl;
 
-        int newConflicts = calculateScore(m_Grid);
+    solved = 0;
+    ms.clear();
 
-        // Found solution
-        if(newConflicts == (m_GridSize*2*m_GridSize))
-            break;
+    for (int seed = 0; seed < runs; ++seed) {
+        Sudoku sudoku{(int) puzzle.size(), (unsigned int) seed};
+        sudoku.setPrintMode(false, false);
+        sudoku.setPropagation(false);
+        sudoku.setInitialValues(puzzle);
 
-        if(newConflicts >= conflicts) {
-            lastImprovement++;
-        } else {
-            lastImprovement = 0;
-        }
+        auto start = chrono::steady_clock::now();
+        AnnealingResult result = sudoku.simulatedAnnealing(ReheatingSchedule(0.5, 0.99999, 5000, 0.5, 20));
+        auto end = chrono::steady_clock::now();
 
-        if((newConflicts > conflicts) && (computeProba(conflicts, newConflicts, temp) < getRandomDouble()) ) {
-            revertSwappedCells(m_Swapped.first, m_Swapped.second);
-        } else {
-            conflicts = newConflicts;
+        if(result.solved) {
+            solved++;
         }
-
-        temp = temp * coolingRate;
-        step++;
-
-        if(PRINT_MODE) {
-            cout << "\033[H";
-            print(step, conflicts, temp);
-            this_thread::sleep_for(chrono::milliseconds(50));
-        }
-        logData(step, conflicts, temp);
+        ms.push_back(chrono::duration<double, milli>(end - start).count());
     }
 
-    if(!PRINT_MODE) {
-        print(step, conflicts, temp);
-    }
+    cout << setw(14) << name << setw(12) << "single"
+         << setw(8) << solved << "/" << runs
+         << setw(12) << fixed << setprecision(2) << percentile(ms, 0.5)
+         << setw(12) << percentile(ms, 0.9) << endl;
 }
 
+//-------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------------------
 
-void Sudoku::writeToFile(const string & path, int runNr) {
-    ofstream out(path, ios::out | ios::app);
+int main(int argc, char ** argv) {
+    // --batch puzzles.txt solutions.txt stats.csv [threads] [seed]
+    if(argc >= 5 && strcmp(argv[1], "--batch") == 0) {
+        ifstream puzzles(argv[2]);
+        ofstream solutions(argv[3]);
+        ofstream stats(argv[4]);
+
+        if(!puzzles || !solutions || !stats) {
+            cout << "Cannot open batch files" << endl;
+            return EXIT_FAILURE;
+        }
 
-    for (size_t i = 0; i < m_RunLog.size(); ++i) {
-        out << runNr << "," << m_RunLog[i].step << "," << m_RunLog[i].conflicts << endl;
-    }
+        BatchOptions options;
+        options.threads = argc >= 6 ? atoi(argv[5]) : (int) thread::hardware_concurrency();
+        options.seed = argc >= 7 ? strtoul(argv[6], nullptr, 10) : 0;
 
-    m_RunLog.clear();
-    out.close();
-}
+        BatchSolver solver{options};
+        solver.run(puzzles, solutions, stats);
 
-//-------------------------------------------------------------------------------------------------------------
-//-------------------------------------------------------------------------------------------------------------
+        return EXIT_SUCCESS;
+    }
 
-int main(int argc, char ** argv) {
     vector<vector<int>> sudokuInit1 = {
             {0, 5, 0,    0, 7, 0,    0, 0, 0},
             {2, 1, 3,    0, 0, 0,    0, 0, 0},
@@ -502,16 +362,12 @@ int main(int argc, char ** argv) {
     };
 /*    Sudoku sudoku2{9};
 
-    string path = "./log3.csv";
-
-    ofstream out(path, ios::out | ios::app);
-    out << "run,iteration,score" << endl;
-    out.close();
+    RunLogger logger{"./log3.csv"};
 
     for (int i = 0; i < 10; ++i) {
+        sudoku2.setLogger(&logger, i+1);
         sudoku2.setInitialValues(sudokuInit2);
         sudoku2.simulatedAnnealing();
-        sudoku2.writeToFile(path, i+1);
     }*/
 
 
@@ -543,16 +399,12 @@ int main(int argc, char ** argv) {
     sudoku3.setInitialValues(sudokuInit3);
     // sudoku3.simulatedAnnealing();
 
-/*    string path = "./log6.csv";
-
-    ofstream out(path, ios::out | ios::app);
-    out << "run,iteration,score" << endl;
-    out.close();
+/*    RunLogger logger{"./log6.csv"};
 
     for (int i = 0; i < 10; ++i) {
+        sudoku3.setLogger(&logger, i+1);
         sudoku3.setInitialValues(sudokuInit3);
         sudoku3.simulatedAnnealing();
-        sudoku3.writeToFile(path, i+1);
     }*/
 
 //-------------------------------------------------------------------------------------------------------------
@@ -584,19 +436,192 @@ int main(int argc, char ** argv) {
     // sudoku4.simulatedAnnealing();
     // sudoku2.print(0,0,0);
 
+//-------------------------------------------------------------------------------------------------------------
+
+    // --checkpoint path every [seed] [--resume] - dlouhý běh na prázdném 25x25 s checkpointem každých every kroků
+    if(argc >= 4 && strcmp(argv[1], "--checkpoint") == 0) {
+        unsigned long every = strtoul(argv[3], nullptr, 10);
+        bool resume = strcmp(argv[argc - 1], "--resume") == 0;
+        unsigned int seed = argc >= 5 && strcmp(argv[4], "--resume") != 0 ? strtoul(argv[4], nullptr, 10) : 0;
+
+        Sudoku sudoku{25, seed};
+        sudoku.setPrintMode(false, false);
+
+        AnnealingResult result = sudoku.simulatedAnnealing(ReheatingSchedule(0.5, 0.99999, 5000, 0.5, 200),
+                                                           argv[2], max(every, 1UL), resume);
+
+        cout << "seed " << sudoku.getSeed() << ": " << result.steps << " steps, score " << result.score
+             << (result.solved ? ", solved" : "") << endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    // --bench-operators runs - porovnání operátorů prohození (bez propagace, ať má žíhání co dělat)
+    if(argc == 3 && strcmp(argv[1], "--bench-operators") == 0) {
+        int runs = atoi(argv[2]);
+
+        cout << setw(14) << "puzzle" << setw(10) << "operator" << setw(11) << "solved"
+             << setw(14) << "steps/s" << setw(12) << "acceptance" << setw(12) << "median ms" << endl;
+
+        benchmarkOperators("sudokuInit1", sudokuInit1, runs);
+        benchmarkOperators("sudokuInit2", sudokuInit2, runs);
+        benchmarkOperators("sudokuInit3", sudokuInit3, runs);
+        benchmarkOperators("sudokuInit4", sudokuInit4, runs);
+
+        return EXIT_SUCCESS;
+    }
+
+    // --bench-kernels [steps] - kroky za sekundu dynamické velikosti proti kernelům pevné velikosti
+    if(argc >= 2 && strcmp(argv[1], "--bench-kernels") == 0) {
+        unsigned long steps = argc >= 3 ? strtoul(argv[2], nullptr, 10) : 5000000;
+
+        cout << setw(14) << "puzzle" << setw(6) << "N" << setw(16) << "dynamic st/s" << setw(16) << "kernel st/s"
+             << setw(10) << "speedup" << setw(16) << "same result" << endl;
+
+        benchmarkKernel<9>("sudokuInit1", sudokuInit1, steps);
+        benchmarkKernel<9>("sudokuInit2", sudokuInit2, steps);
+        benchmarkKernel<16>("sudokuInit3", sudokuInit3, steps);
+        benchmarkKernel<16>("sudokuInit4", sudokuInit4, steps);
+        benchmarkKernel<25>("empty25", vector<vector<int>>(25, vector<int>(25, 0)), steps);
+
+        return EXIT_SUCCESS;
+    }
+
+    // --hybrid budgetMs [puzzles.txt] - přesný řešič, žíhání a hybrid na vestavěných sudoku nebo ze souboru
+    if(argc >= 3 && strcmp(argv[1], "--hybrid") == 0) {
+        double budgetMs = atof(argv[2]);
+
+        cout << setw(20) << "puzzle" << setw(18) << "exact ms" << setw(18) << "annealing ms"
+             << setw(18) << "hybrid ms" << setw(12) << "engine" << endl;
+
+        if(argc >= 4) {
+            ifstream in(argv[3]);
+            string line;
+            string name;
+            vector<vector<int>> grid;
+
+            while (getline(in, line)) {
+                if(!line.empty() && line[0] == '#') {
+                    name = line.substr(min(line.size(), (size_t) 2));
+                } else if(BatchSolver::parsePuzzle(line, grid)) {
+                    benchmarkHybrid(name, grid, budgetMs);
+                }
+            }
+
+            return EXIT_SUCCESS;
+        }
+
+        benchmarkHybrid("sudokuInit1", sudokuInit1, budgetMs);
+        benchmarkHybrid("sudokuInit2", sudokuInit2, budgetMs);
+        benchmarkHybrid("sudokuInit3", sudokuInit3, budgetMs);
+        benchmarkHybrid("sudokuInit4", sudokuInit4, budgetMs);
+
+        return EXIT_SUCCESS;
+    }
+
+    // --log path runs [every] [--binary] - průběh běhů na prázdném 25x25 do logu
+    if(argc >= 4 && strcmp(argv[1], "--log") == 0) {
+        LogOptions options;
+        int runs = atoi(argv[3]);
+
+        for (int i = 4; i < argc; ++i) {
+            if(strcmp(argv[i], "--binary") == 0) {
+                options.binary = true;
+            } else {
+                options.every = strtoul(argv[i], nullptr, 10);
+            }
+        }
+
+        RunLogger logger{argv[2], options};
+        if(!logger.isOpen()) {
+            cout << "Cannot open " << argv[2] << endl;
+            return EXIT_FAILURE;
+        }
+
+        auto start = chrono::steady_clock::now();
+
+        for (int i = 0; i < runs; ++i) {
+            Sudoku sudoku{25, (unsigned int) i};
+            sudoku.setPrintMode(false, false);
+            sudoku.setLogger(&logger, i + 1);
+            AnnealingResult result = sudoku.simulatedAnnealing();
+            cout << "run " << i + 1 << ": " << result.steps << " steps, score " << result.score << endl;
+        }
+
+        logger.close();
+        auto end = chrono::steady_clock::now();
+        cout << "Time: " << chrono::duration<double, milli>(end - start).count() << " ms" << endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    // --export-log log.bin log.csv
+    if(argc == 4 && strcmp(argv[1], "--export-log") == 0) {
+        if(!RunLogger::exportCsv(argv[2], argv[3])) {
+            cout << "Cannot convert " << argv[2] << endl;
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    // --propagation runs
+    if(argc == 3 && strcmp(argv[1], "--propagation") == 0) {
+        int runs = atoi(argv[2]);
+
+        cout << setw(14) << "puzzle" << setw(10) << "log10 S" << setw(10) << "after"
+             << setw(11) << "solved" << setw(12) << "median ms" << setw(11) << "solved+p" << setw(12) << "median ms"
+             << endl;
+
+        benchmarkPropagation("sudokuInit1", sudokuInit1, runs);
+        benchmarkPropagation("sudokuInit2", sudokuInit2, runs);
+        benchmarkPropagation("sudokuInit3", sudokuInit3, runs);
+        benchmarkPropagation("sudokuInit4", sudokuInit4, runs);
+
+        return EXIT_SUCCESS;
+    }
+
+    // --tempering runs [replicas]
+    if(argc >= 3 && strcmp(argv[1], "--tempering") == 0) {
+        int runs = atoi(argv[2]);
+        int replicas = argc >= 4 ? atoi(argv[3]) : max((int) thread::hardware_concurrency(), 2);
+        replicas = max(replicas, 2);
+
+        cout << setw(14) << "puzzle" << setw(12) << "method" << setw(11) << "solved"
+             << setw(12) << "median ms" << setw(12) << "p90 ms" << "   (" << replicas << " replicas)" << endl;
+
+        benchmarkTempering("sudokuInit1", sudokuInit1, runs, replicas);
+        benchmarkTempering("sudokuInit2", sudokuInit2, runs, replicas);
+        benchmarkTempering("sudokuInit3", sudokuInit3, runs, replicas);
+        benchmarkTempering("sudokuInit4", sudokuInit4, runs, replicas);
+
+        return EXIT_SUCCESS;
+    }
+
+    if(argc == 3 && strcmp(argv[1], "--bench-schedules") == 0) {
+        int runs = atoi(argv[2]);
+
+        cout << setw(14) << "puzzle" << setw(12) << "schedule" << setw(11) << "solved"
+             << setw(14) << "median steps" << setw(12) << "median ms" << setw(12) << "p90 ms" << endl;
+
+        benchmarkSchedules("sudokuInit1", sudokuInit1, runs);
+        benchmarkSchedules("sudokuInit2", sudokuInit2, runs);
+        benchmarkSchedules("sudokuInit3", sudokuInit3, runs);
+        benchmarkSchedules("sudokuInit4", sudokuInit4, runs);
+        benchmarkSchedules("empty25", vector<vector<int>>(25, vector<int>(25, 0)), runs);
+
+        return EXIT_SUCCESS;
+    }
+
 //-------------------------------------------------------------------------------------------------------------
     Sudoku sudoku5{25};
     // sudoku5.simulatedAnnealing();
 
-/*    string path = "./log7.csv";
-
-    ofstream out(path, ios::out | ios::app);
-    out << "run,iteration,score" << endl;
-    out.close();
+/*    RunLogger logger{"./log7.csv"};
 
     for (int i = 0; i < 10; ++i) {
         Sudoku sudoku5{25};
+        sudoku5.setLogger(&logger, i+1);
         sudoku5.simulatedAnnealing();
-        sudoku5.writeToFile(path, i+1);
     }*/
 }
\ No newline at end of file